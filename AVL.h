@@ -2,42 +2,214 @@
 #define AVLTree_H
 #include <iostream>
 #include <sstream>
+#include <memory>
+#include <type_traits>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
 #include "AVL_Node.h"
+#include "NodePool.h"
 #include "AVL_Iterator.h"
+#include "FrozenAVL.h"
+#include "KeyWriter.h"
+#include "DictStats.h"
 
 using namespace std;
 
-template <typename T>
+template <typename T, typename Alloc = std::allocator<T>>
 class AVLTree
 {
 public:
     typedef AVLIterator<T> iterator;
     iterator begin(AVLIterator<int>::Type _)
     {
-        return iterator(root, _);
+        return iterator(root, (typename iterator::Type)_);
     } // Retorna el inicio del iterador
 
     iterator end()
     {
-        return iterator(nullptr, AVLIterator<int>::InOrder);
+        return iterator(nullptr, iterator::InOrder);
     } // Retorna el final del iterador
 
+    iterator lower_bound(const T &value) // Primer elemento >= value, o end() O(log n)
+    {
+        return iterator::seek(root, value, false);
+    }
+
+    iterator upper_bound(const T &value) // Primer elemento > value, o end() O(log n)
+    {
+        return iterator::seek(root, value, true);
+    }
+
+    /*Par de iteradores InOrder para recorrer con un for de rango*/
+    struct Range
+    {
+        iterator first;
+        iterator last;
+
+        iterator begin() const { return first; }
+        iterator end() const { return last; }
+        bool empty() const { return !(first != last); }
+    };
+
+    Range range(const T &lo, const T &hi) // Elementos en [lo, hi] O(log n + k)
+    {
+        if (hi < lo)
+            return Range{end(), end()};
+        return Range{lower_bound(lo), upper_bound(hi)};
+    }
+
+    /*Elementos que empiezan con prefix: [prefix, siguiente prefijo)*/
+    template <typename U = T>
+    typename enable_if<is_same<U, string>::value, Range>::type prefix(const string &prefix)
+    {
+        string next = prefix;
+        while (!next.empty() && (unsigned char)next.back() == 0xFF)
+            next.pop_back();
+        if (next.empty())
+            return Range{lower_bound(prefix), end()};
+        next.back() = (char)((unsigned char)next.back() + 1);
+        return Range{lower_bound(prefix), lower_bound(next)};
+    }
+
 private:
+    typedef typename allocator_traits<Alloc>::template rebind_alloc<NodeAVL<T>> NodeAlloc;
+    typedef allocator_traits<NodeAlloc> NodeTraits;
+
     NodeAVL<T> *root;
+    NodeAlloc nodeAlloc;
+
+#ifdef DICT_STATS
+    size_t statLL = 0, statRR = 0, statLR = 0, statRL = 0;
+    size_t statSearches = 0;
+    size_t statDepth = 0;
+#endif
 
 public:
-    AVLTree() : root(nullptr) {}
+    AVLTree(const Alloc &alloc = Alloc()) : root(nullptr), nodeAlloc(alloc) {}
+
+    /*Construye desde un rango ordenado en O(n) (ver assign_sorted)*/
+    template <typename It, typename = typename iterator_traits<It>::iterator_category>
+    AVLTree(It first, It last, const Alloc &alloc = Alloc()) : root(nullptr), nodeAlloc(alloc)
+    {
+        assign_sorted(first, last);
+    }
+
+    AVLTree(const AVLTree &other)
+        : root(nullptr), nodeAlloc(NodeTraits::select_on_container_copy_construction(other.nodeAlloc))
+    {
+        root = cloneTree(other.root);
+    }
 
-    void insert(T value) // O(log n)
+    AVLTree(AVLTree &&other) noexcept(is_nothrow_copy_constructible<NodeAlloc>::value)
+        : root(other.root), nodeAlloc(other.nodeAlloc)
     {
-        insert(root, value);
+        other.root = nullptr;
     }
 
-    bool find(T value) // O(log n)
+    AVLTree &operator=(AVLTree other)
     {
+        std::swap(root, other.root);
+        std::swap(nodeAlloc, other.nodeAlloc);
+        return *this;
+    }
+
+    void insert(const T &value) // O(log n)
+    {
+        insertKey(value);
+    }
+
+    void insert(T &&value) // O(log n)
+    {
+        insertKey(std::move(value));
+    }
+
+    /*Reemplaza el contenido por un rango ordenado (los repetidos se ignoran)
+      y arma un arbol perfectamente balanceado en O(n). Lanza invalid_argument
+      si el rango no esta ordenado; en ese caso el arbol queda vacio*/
+    template <typename It>
+    void assign_sorted(It first, It last)
+    {
+        clear();
+        size_t n;
+        NodeAVL<T> *list = sortedList(first, last, n);
+        root = buildFromList(list, n);
+    }
+
+    /*Inserta un lote ordenado: si es grande frente al arbol se mezcla con el
+      recorrido en orden y se reconstruye en O(n + m); si es chico se inserta
+      uno por uno. Lanza invalid_argument si el lote no esta ordenado (el
+      arbol no cambia)*/
+    template <typename It>
+    void insert_bulk(It first, It last)
+    {
+        size_t m;
+        NodeAVL<T> *batch = sortedList(first, last, m);
+        if (!batch)
+            return;
+
+        // n <= 2^(h+1) - 1: con m * log n < n conviene insertar uno a uno
+        int levels = height(root) + 1;
+        if (levels < 62 && m * (size_t)(levels + 1) < ((size_t)1 << levels))
+        {
+            while (batch)
+            {
+                NodeAVL<T> *next = batch->right;
+                insertKey(std::move(batch->data));
+                destroyNode(batch);
+                batch = next;
+            }
+            return;
+        }
+
+        NodeAVL<T> *current = toList(root);
+        NodeAVL<T> *head = nullptr;
+        NodeAVL<T> **tail = &head;
+        size_t total = 0;
+        while (current && batch)
+        {
+            NodeAVL<T> *next;
+            if (batch->data < current->data)
+            {
+                next = batch;
+                batch = batch->right;
+            }
+            else
+            {
+                next = current;
+                current = current->right;
+                if (!(next->data < batch->data)) // ya estaba en el arbol
+                {
+                    NodeAVL<T> *dup = batch;
+                    batch = batch->right;
+                    destroyNode(dup);
+                }
+            }
+            *tail = next;
+            tail = &next->right;
+            total++;
+        }
+        for (NodeAVL<T> *rest = current ? current : batch; rest; rest = rest->right)
+        {
+            *tail = rest;
+            tail = &rest->right;
+            total++;
+        }
+        *tail = nullptr;
+        root = buildFromList(head, total);
+    }
+
+    bool find(const T &value) // O(log n)
+    {
+        DICT_STAT(statSearches++);
         NodeAVL<T> *current = root;
         while (current != nullptr)
         {
+            DICT_STAT(statDepth++);
             if (value < current->data)
                 current = current->left;
             else if (value > current->data)
@@ -48,25 +220,104 @@ public:
         return false;
     }
 
+    /*Recorridos con visitante: f(const T&) por cada elemento, sin recursion
+      ni memoria dinamica (la pila en linea la acota la altura) O(n)*/
+    template <typename F>
+    void for_each_inorder(F f)
+    {
+        auto visit = [&f](NodeAVL<T> *node) { f(const_cast<const T &>(node->data)); };
+        visitInOrder(root, visit);
+    }
+
+    template <typename F>
+    void for_each_preorder(F f)
+    {
+        NodeAVL<T> *stack[MaxPath];
+        int depth = 0;
+        if (root)
+            stack[depth++] = root;
+        while (depth)
+        {
+            NodeAVL<T> *node = stack[--depth];
+            f(const_cast<const T &>(node->data));
+            if (node->right)
+                stack[depth++] = node->right;
+            if (node->left)
+                stack[depth++] = node->left;
+        }
+    }
+
+    template <typename F>
+    void for_each_postorder(F f)
+    {
+        NodeAVL<T> *stack[MaxPath];
+        int depth = 0;
+        NodeAVL<T> *node = root;
+        NodeAVL<T> *last = nullptr; // ultimo visitado: dice si ya se bajo por la derecha
+        while (node || depth)
+        {
+            if (node)
+            {
+                stack[depth++] = node;
+                node = node->left;
+                continue;
+            }
+            NodeAVL<T> *top = stack[depth - 1];
+            if (top->right && top->right != last)
+            {
+                node = top->right;
+            }
+            else
+            {
+                f(const_cast<const T &>(top->data));
+                last = top;
+                depth--;
+            }
+        }
+    }
+
+    /*Vuelcan las claves a un KeyWriter (fd, string u ostream) en bloques de
+      tamano fijo; cada clave seguida del separador*/
+    void write_inorder(KeyWriter &out)
+    {
+        for_each_inorder([&out](const T &value) { out.put(value); });
+    }
+
+    void write_preorder(KeyWriter &out)
+    {
+        for_each_preorder([&out](const T &value) { out.put(value); });
+    }
+
+    void write_postorder(KeyWriter &out)
+    {
+        for_each_postorder([&out](const T &value) { out.put(value); });
+    }
+
     string getInOrder()
     {
-        stringstream ss;
-        getInOrder(root, ss);
-        return ss.str();
+        string result;
+        KeyWriter out(result);
+        write_inorder(out);
+        out.flush();
+        return result;
     }
 
     string getPreOrder()
     {
-        stringstream ss;
-        getPreOrder(root, ss);
-        return ss.str();
+        string result;
+        KeyWriter out(result);
+        write_preorder(out);
+        out.flush();
+        return result;
     }
 
     string getPostOrder()
     {
-        stringstream ss;
-        getPostOrder(root, ss);
-        return ss.str();
+        string result;
+        KeyWriter out(result);
+        write_postorder(out);
+        out.flush();
+        return result;
     }
 
     int height()
@@ -90,19 +341,179 @@ public:
         return current->data;
     }
 
-    bool isBalanced() // O(n)
+    /*Recorridos paralelos: el arbol se corta en subarboles de hasta grain
+      nodos que los hilos se van repartiendo. threads = 0 usa todos los
+      nucleos y grain = 0 lo elige segun el tamano (un arbol chico se recorre
+      en el hilo que llama). El arbol no debe modificarse mientras tanto*/
+    template <typename F>
+    void parallel_for_each(F f, unsigned threads = 0, size_t grain = 0) // f(const T&) concurrente, sin orden O(n / hilos)
+    {
+        vector<Piece> pieces;
+        threads = planPieces(threads, grain, pieces);
+        runPieces(pieces.size(), threads, [&](size_t i) {
+            auto visit = [&f](NodeAVL<T> *node, size_t) { f(const_cast<const T &>(node->data)); };
+            visitPiece(pieces[i], visit);
+        });
+    }
+
+    /*Como parallel_for_each pero f(i, value) recibe la posicion en orden de
+      cada elemento: sirve para llenar una salida ordenada en paralelo*/
+    template <typename F>
+    void parallel_for_each_indexed(F f, unsigned threads = 0, size_t grain = 0)
     {
-        return isBalanced(root);
+        vector<Piece> pieces;
+        threads = planPieces(threads, grain, pieces);
+        runPieces(pieces.size(), threads, [&](size_t i) {
+            auto visit = [&f](NodeAVL<T> *node, size_t pos) { f(pos, const_cast<const T &>(node->data)); };
+            visitPiece(pieces[i], visit);
+        });
     }
 
-    int size()
+    /*Combina map(x) de todos los elementos con combine, que debe ser
+      asociativa con identity como neutro. Los parciales de cada trozo se
+      combinan en orden, asi el resultado es el del recorrido en orden aunque
+      combine no sea conmutativa*/
+    template <typename R, typename Map, typename Combine>
+    R parallel_reduce(R identity, Map map, Combine combine, unsigned threads = 0, size_t grain = 0)
     {
-        return size(root);
+        vector<Piece> pieces;
+        threads = planPieces(threads, grain, pieces);
+        struct alignas(64) Slot // un parcial por linea de cache: los hilos no comparten lineas al escribir
+        {
+            R value;
+        };
+        vector<Slot> partial(pieces.size(), Slot{identity});
+        runPieces(pieces.size(), threads, [&](size_t i) {
+            R acc = identity;
+            auto visit = [&](NodeAVL<T> *node, size_t) { acc = combine(std::move(acc), map(const_cast<const T &>(node->data))); };
+            visitPiece(pieces[i], visit);
+            partial[i].value = std::move(acc);
+        });
+        R result = identity;
+        for (Slot &slot : partial)
+            result = combine(std::move(result), std::move(slot.value));
+        return result;
+    }
+
+    bool isBalanced(unsigned threads = 1) // O(n); con threads > 1 (0 = todos los nucleos) en paralelo
+    {
+        vector<Piece> pieces;
+        threads = planPieces(threads, 0, pieces);
+        atomic<bool> balanced(true);
+        runPieces(pieces.size(), threads, [&](size_t i) {
+            auto visit = [&](NodeAVL<T> *node, size_t) {
+                int bf = balancingFactor(node);
+                if (bf > 1 || bf < -1)
+                    balanced.store(false, memory_order_relaxed);
+            };
+            visitPiece(pieces[i], visit);
+        });
+        return balanced.load();
     }
 
-    void remove(T value) // Use el predecesor para cuando el nodo a eliminar tiene dos hijos
+    /*Verifica en cada nodo el orden de las claves, height, count
+      (1 + count de los hijos) y el factor de balance O(n)*/
+    bool checkInvariants()
     {
-        remove(root, value);
+        int h;
+        size_t c;
+        return checkNode(root, nullptr, nullptr, h, c);
+    }
+
+    int size() // O(1)
+    {
+        return (int)count(root);
+    }
+
+    /*Estadisticas de orden: cada nodo guarda el tamano de su subarbol*/
+    size_t rank(const T &value) // Cantidad de elementos menores que value O(log n)
+    {
+        return countBelow(value, false);
+    }
+
+    T select(size_t k) // k-esimo menor elemento, desde 0 O(log n)
+    {
+        NodeAVL<T> *current = root;
+        while (current)
+        {
+            size_t leftCount = count(current->left);
+            if (k < leftCount)
+            {
+                current = current->left;
+            }
+            else if (k == leftCount)
+            {
+                return current->data;
+            }
+            else
+            {
+                k -= leftCount + 1;
+                current = current->right;
+            }
+        }
+        throw out_of_range("Index out of range");
+    }
+
+    size_t count_range(const T &lo, const T &hi) // Cantidad de elementos en [lo, hi] O(log n)
+    {
+        if (hi < lo)
+            return 0;
+        return countBelow(hi, true) - countBelow(lo, false);
+    }
+
+    void remove(const T &value) // Use el predecesor para cuando el nodo a eliminar tiene dos hijos
+    {
+        NodeAVL<T> **path[MaxPath];
+        int n = 0;
+        NodeAVL<T> **link = &root;
+        while (*link)
+        {
+            if (value < (*link)->data)
+            {
+                path[n++] = link;
+                link = &(*link)->left;
+            }
+            else if ((*link)->data < value)
+            {
+                path[n++] = link;
+                link = &(*link)->right;
+            }
+            else
+            {
+                break;
+            }
+        }
+        NodeAVL<T> *node = *link;
+        if (!node)
+            return;
+
+        if (node->left && node->right)
+        {
+            // El predecesor se desengancha y toma el lugar del nodo en una pasada
+            path[n++] = link;
+            int below = n;
+            NodeAVL<T> **predLink = &node->left;
+            while ((*predLink)->right)
+            {
+                path[n++] = predLink;
+                predLink = &(*predLink)->right;
+            }
+            NodeAVL<T> *pred = *predLink;
+            *predLink = pred->left;
+            pred->left = node->left;
+            pred->right = node->right;
+            pred->height = node->height;
+            pred->count = node->count;
+            *link = pred;
+            if (below < n)
+                path[below] = &pred->left;
+        }
+        else
+        {
+            *link = node->left ? node->left : node->right;
+        }
+        destroyNode(node);
+        retrace(path, n, -1);
     }
 
     /*Adicionales*/
@@ -144,13 +555,199 @@ public:
         return pred ? pred->data : T();
     }
 
-    void clear() // Liberar todos los nodos (usar root->KillSelf)
+    bool successor(const T &value, T &out) // Como successor() pero indica si existe
+    {
+        NodeAVL<T> *current = root;
+        NodeAVL<T> *succ = nullptr;
+        while (current)
+        {
+            if (value < current->data)
+            {
+                succ = current;
+                current = current->left;
+            }
+            else
+            {
+                current = current->right;
+            }
+        }
+        if (!succ)
+            return false;
+        out = succ->data;
+        return true;
+    }
+
+    bool predecessor(const T &value, T &out) // Como predecessor() pero indica si existe
+    {
+        NodeAVL<T> *current = root;
+        NodeAVL<T> *pred = nullptr;
+        while (current)
+        {
+            if (current->data < value)
+            {
+                pred = current;
+                current = current->right;
+            }
+            else
+            {
+                current = current->left;
+            }
+        }
+        if (!pred)
+            return false;
+        out = pred->data;
+        return true;
+    }
+
+    /*Algebra de conjuntos por split/join: O(m log(n/m + 1)) para m <= n.
+      Modifican este arbol; si una reserva falla el arbol queda vacio*/
+    void unite(const AVLTree &other) // Agrega las claves de other (copia solo las que faltan)
+    {
+        NodeAVL<T> *node = root;
+        root = nullptr;
+        root = uniteCopy(node, other.root);
+    }
+
+    void unite(AVLTree &&other) // Agrega las claves de other reusando sus nodos
+    {
+        if (&other == this)
+            return;
+        if (!(nodeAlloc == other.nodeAlloc))
+        {
+            unite(other);
+            return;
+        }
+        root = uniteOwned(root, other.root);
+        other.root = nullptr;
+    }
+
+    void intersect(const AVLTree &other) // Deja solo las claves que tambien estan en other
+    {
+        if (&other != this)
+            root = intersectWith(root, other.root);
+    }
+
+    void difference(const AVLTree &other) // Quita las claves que estan en other
+    {
+        if (&other == this)
+            clear();
+        else
+            root = differenceWith(root, other.root);
+    }
+
+    bool is_subset(const AVLTree &other) // Todas las claves estan en other
     {
+        size_t m = count(root), n = count(other.root);
+        if (m > n)
+            return false;
+        size_t logn = 0;
+        while ((n >> logn) > 0)
+            logn++;
+
+        iterator it = begin(AVLIterator<int>::InOrder);
+        if (m * logn < m + n) // m busquedas en other
+        {
+            NodeAVL<T> *otherRoot = other.root;
+            for (; it != end(); ++it)
+            {
+                const T &key = *it;
+                NodeAVL<T> *current = otherRoot;
+                while (current && (key < current->data || current->data < key))
+                    current = key < current->data ? current->left : current->right;
+                if (!current)
+                    return false;
+            }
+            return true;
+        }
+        // Recorrido en paralelo de ambos arboles
+        iterator jt = iterator(other.root, iterator::InOrder);
+        for (; it != end(); ++it)
+        {
+            while (jt != end() && *jt < *it)
+                ++jt;
+            if (!(jt != end()) || *it < *jt)
+                return false;
+        }
+        return true;
+    }
+
+    /*Deja en este arbol las claves < key y retorna otro con las >= key en
+      O(log n); los nodos se mueven, los dos comparten el allocator*/
+    AVLTree split(const T &key)
+    {
+        NodeAVL<T> *l, *m, *r;
+        splitNodes(root, key, l, m, r);
+        root = l;
+        AVLTree result{Alloc(nodeAlloc)};
+        result.root = m ? joinNodes(nullptr, m, r) : r;
+        return result;
+    }
+
+    /*Agrega other, cuyas claves son todas menores o todas mayores que las de
+      este arbol, en O(log n). Lanza invalid_argument si los rangos se solapan.
+      Con allocators distintos las claves se copian*/
+    void join(AVLTree &&other)
+    {
+        if (&other == this || !other.root)
+            return;
+        bool after = true;
         if (root)
         {
-            root->killSelf();
-            root = nullptr;
+            after = maxValue() < other.minValue();
+            if (!after && !(other.maxValue() < minValue()))
+                throw invalid_argument("Key ranges overlap");
+        }
+        if (!(nodeAlloc == other.nodeAlloc))
+        {
+            unite(other);
+            return;
         }
+        root = after ? join2(root, other.root) : join2(other.root, root);
+        other.root = nullptr;
+    }
+
+    static AVLTree join(AVLTree &&left, AVLTree &&right)
+    {
+        left.join(std::move(right));
+        return std::move(left);
+    }
+
+    FrozenAVL<T> freeze() // Copia inmutable en un arreglo para busquedas de solo lectura O(n)
+    {
+        return FrozenAVL<T>(begin(AVLIterator<int>::InOrder), count(root));
+    }
+
+#ifdef DICT_STATS
+    /*Rotaciones de balance(), profundidad de find y memoria de los nodos.
+      Los contadores se acumulan desde reset_stats()*/
+    AVLTreeStats stats()
+    {
+        AVLTreeStats s;
+        s.size = count(root);
+        s.height = height(root);
+        s.rotationsLL = statLL;
+        s.rotationsRR = statRR;
+        s.rotationsLR = statLR;
+        s.rotationsRL = statRL;
+        s.searches = statSearches;
+        s.avgSearchDepth = statSearches ? (double)statDepth / (double)statSearches : 0;
+        s.bytes = s.size * sizeof(NodeAVL<T>);
+        if constexpr (is_same<T, string>::value)
+            for_each_inorder([&s](const T &value) { s.bytes += heapBytes(value); });
+        return s;
+    }
+
+    void reset_stats()
+    {
+        statLL = statRR = statLR = statRL = 0;
+        statSearches = statDepth = 0;
+    }
+#endif
+
+    void clear() // Liberar todos los nodos
+    {
+        destroyTree(root);
+        root = nullptr;
     }
 
     void displayPretty() // Muestra el arbol visualmente atractivo
@@ -160,62 +757,367 @@ public:
 
     ~AVLTree()
     {
-        if (this->root != nullptr)
-        {
-            this->root->killSelf();
-        }
+        destroyTree(this->root);
     }
 
 private:
-    void insert(NodeAVL<T> *&node, T value)
+    template <typename... Args>
+    NodeAVL<T> *createNode(Args &&...args)
     {
-        if (node == nullptr)
+        NodeAVL<T> *node = NodeTraits::allocate(nodeAlloc, 1);
+        try
+        {
+            NodeTraits::construct(nodeAlloc, node, std::forward<Args>(args)...);
+        }
+        catch (...)
         {
-            node = new NodeAVL<T>(value);
+            NodeTraits::deallocate(nodeAlloc, node, 1);
+            throw;
+        }
+        return node;
+    }
+
+    void destroyNode(NodeAVL<T> *node)
+    {
+        NodeTraits::destroy(nodeAlloc, node);
+        NodeTraits::deallocate(nodeAlloc, node, 1);
+    }
+
+    /*Libera el arbol completo. Con un PoolAllocator propio y T trivial basta
+      con soltar los chunks; si no se recorren los nodos*/
+    void destroyTree(NodeAVL<T> *node)
+    {
+        if (!node)
             return;
+        bool bulk = poolExclusive(nodeAlloc);
+        if (!bulk || !is_trivially_destructible<T>::value)
+            destroySubtree(node, !bulk);
+        if (bulk)
+            poolRelease(nodeAlloc);
+    }
+
+    /*Libera un subarbol sin recursion: cada rotacion a la derecha deja el
+      hijo izquierdo arriba hasta que el nodo actual no tiene izquierdo*/
+    void destroySubtree(NodeAVL<T> *node, bool deallocate = true)
+    {
+        while (node)
+        {
+            if (node->left)
+            {
+                NodeAVL<T> *l = node->left;
+                node->left = l->right;
+                l->right = node;
+                node = l;
+            }
+            else
+            {
+                NodeAVL<T> *next = node->right;
+                if (deallocate)
+                    destroyNode(node);
+                else
+                    NodeTraits::destroy(nodeAlloc, node);
+                node = next;
+            }
         }
+    }
+
+    /*Camino de la raiz al nodo: la altura de un AVL lo acota (ver AVLIterator)*/
+    static const int MaxPath = AVLIterator<T>::MaxDepth;
 
-        if (value < node->data)
+    template <typename K>
+    void insertKey(K &&value)
+    {
+        NodeAVL<T> **path[MaxPath];
+        int n = 0;
+        NodeAVL<T> **link = &root;
+        while (*link)
         {
-            insert(node->left, value);
+            path[n++] = link;
+            if (value < (*link)->data)
+                link = &(*link)->left;
+            else if ((*link)->data < value)
+                link = &(*link)->right;
+            else
+                return;
         }
-        else if (value > node->data)
+        *link = createNode(std::forward<K>(value));
+        retrace(path, n, 1);
+    }
+
+    /*Rebalancea de abajo hacia arriba; cuando la altura de un subarbol no
+      cambia ya no hay rotaciones arriba y solo falta ajustar los count*/
+    void retrace(NodeAVL<T> **path[], int n, int delta)
+    {
+        while (n > 0)
         {
-            insert(node->right, value);
+            NodeAVL<T> **link = path[--n];
+            int oldHeight = (*link)->height;
+            balance(*link);
+            if ((*link)->height == oldHeight)
+            {
+                while (n > 0)
+                    (*path[--n])->count += delta;
+                return;
+            }
         }
-        else
+    }
+
+    /*Une left < node < right en O(|h(left) - h(right)|): baja por el lado
+      del mas alto hasta una altura pareja y rebalancea al subir*/
+    NodeAVL<T> *joinNodes(NodeAVL<T> *left, NodeAVL<T> *node, NodeAVL<T> *right)
+    {
+        int hl = height(left), hr = height(right);
+        if (hl > hr + 1)
         {
-            return;
+            left->right = joinNodes(left->right, node, right);
+            balance(left);
+            return left;
+        }
+        if (hr > hl + 1)
+        {
+            right->left = joinNodes(left, node, right->left);
+            balance(right);
+            return right;
         }
+        node->left = left;
+        node->right = right;
+        updateHeight(node);
+        return node;
+    }
 
-        balance(node);
+    // Separa el maximo de un arbol no vacio; retorna el resto
+    NodeAVL<T> *splitLast(NodeAVL<T> *node, NodeAVL<T> *&last)
+    {
+        if (!node->right)
+        {
+            NodeAVL<T> *rest = node->left;
+            node->left = nullptr;
+            last = node;
+            return rest;
+        }
+        NodeAVL<T> *rest = splitLast(node->right, last);
+        return joinNodes(node->left, node, rest);
     }
 
-    void getInOrder(NodeAVL<T> *node, stringstream &ss)
+    // Une dos arboles con todas las claves de left < las de right
+    NodeAVL<T> *join2(NodeAVL<T> *left, NodeAVL<T> *right)
     {
-        if (!node)
-            return;
-        getInOrder(node->left, ss);
-        ss << node->data << " ";
-        getInOrder(node->right, ss);
+        if (!left)
+            return right;
+        if (!right)
+            return left;
+        NodeAVL<T> *last;
+        left = splitLast(left, last);
+        return joinNodes(left, last, right);
     }
 
-    void getPreOrder(NodeAVL<T> *node, stringstream &ss)
+    /*Parte un arbol en claves < key y > key en O(log n); mid queda con el
+      nodo de key (suelto) o nullptr*/
+    void splitNodes(NodeAVL<T> *node, const T &key, NodeAVL<T> *&left, NodeAVL<T> *&mid, NodeAVL<T> *&right)
     {
         if (!node)
+        {
+            left = mid = right = nullptr;
             return;
-        ss << node->data << " ";
-        getPreOrder(node->left, ss);
-        getPreOrder(node->right, ss);
+        }
+        NodeAVL<T> *l = node->left;
+        NodeAVL<T> *r = node->right;
+        if (key < node->data)
+        {
+            NodeAVL<T> *rest;
+            splitNodes(l, key, left, mid, rest);
+            right = joinNodes(rest, node, r);
+        }
+        else if (node->data < key)
+        {
+            NodeAVL<T> *rest;
+            splitNodes(r, key, rest, mid, right);
+            left = joinNodes(l, node, rest);
+        }
+        else
+        {
+            left = l;
+            right = r;
+            node->left = node->right = nullptr;
+            updateHeight(node);
+            mid = node;
+        }
+    }
+
+    // a es propio; de b solo se copian las claves que faltan
+    NodeAVL<T> *uniteCopy(NodeAVL<T> *a, NodeAVL<T> *b)
+    {
+        if (!b)
+            return a;
+        if (!a)
+            return cloneTree(b);
+        NodeAVL<T> *l, *m, *r;
+        splitNodes(a, b->data, l, m, r);
+        NodeAVL<T> *left = nullptr;
+        try
+        {
+            if (!m)
+                m = createNode(b->data);
+            NodeAVL<T> *part = l;
+            l = nullptr;
+            left = uniteCopy(part, b->left); // si falla ya libero part
+            part = r;
+            r = nullptr;
+            return joinNodes(left, m, uniteCopy(part, b->right));
+        }
+        catch (...)
+        {
+            destroySubtree(l);
+            destroySubtree(r);
+            destroySubtree(left);
+            if (m)
+                destroyNode(m);
+            throw;
+        }
     }
 
-    void getPostOrder(NodeAVL<T> *node, stringstream &ss)
+    // Ambos son propios: el resultado reusa sus nodos
+    NodeAVL<T> *uniteOwned(NodeAVL<T> *a, NodeAVL<T> *b)
+    {
+        if (!b)
+            return a;
+        if (!a)
+            return b;
+        NodeAVL<T> *bl = b->left;
+        NodeAVL<T> *br = b->right;
+        NodeAVL<T> *l, *m, *r;
+        splitNodes(a, b->data, l, m, r);
+        if (m)
+            destroyNode(m);
+        NodeAVL<T> *left = uniteOwned(l, bl);
+        return joinNodes(left, b, uniteOwned(r, br));
+    }
+
+    NodeAVL<T> *intersectWith(NodeAVL<T> *a, NodeAVL<T> *b)
+    {
+        if (!a)
+            return nullptr;
+        if (!b)
+        {
+            destroySubtree(a);
+            return nullptr;
+        }
+        NodeAVL<T> *l, *m, *r;
+        splitNodes(a, b->data, l, m, r);
+        NodeAVL<T> *left = intersectWith(l, b->left);
+        NodeAVL<T> *right = intersectWith(r, b->right);
+        return m ? joinNodes(left, m, right) : join2(left, right);
+    }
+
+    NodeAVL<T> *differenceWith(NodeAVL<T> *a, NodeAVL<T> *b)
+    {
+        if (!a || !b)
+            return a;
+        NodeAVL<T> *l, *m, *r;
+        splitNodes(a, b->data, l, m, r);
+        if (m)
+            destroyNode(m);
+        NodeAVL<T> *left = differenceWith(l, b->left);
+        return join2(left, differenceWith(r, b->right));
+    }
+
+    /*Crea los nodos de un rango ordenado enlazados por right, sin repetidos*/
+    template <typename It>
+    NodeAVL<T> *sortedList(It first, It last, size_t &n)
+    {
+        NodeAVL<T> *head = nullptr;
+        NodeAVL<T> *tail = nullptr;
+        n = 0;
+        try
+        {
+            for (; first != last; ++first)
+            {
+                if (tail && !(tail->data < *first))
+                {
+                    if (*first < tail->data)
+                        throw invalid_argument("Range is not sorted");
+                    continue;
+                }
+                NodeAVL<T> *node = createNode(*first);
+                if (tail)
+                    tail->right = node;
+                else
+                    head = node;
+                tail = node;
+                n++;
+            }
+        }
+        catch (...)
+        {
+            while (head)
+            {
+                NodeAVL<T> *next = head->right;
+                destroyNode(head);
+                head = next;
+            }
+            throw;
+        }
+        return head;
+    }
+
+    /*Aplana el arbol a una lista en orden enlazada por right, en O(n) y sin
+      memoria extra (las mismas rotaciones que destroyTree)*/
+    NodeAVL<T> *toList(NodeAVL<T> *node)
+    {
+        NodeAVL<T> *head = nullptr;
+        NodeAVL<T> **tail = &head;
+        while (node)
+        {
+            if (node->left)
+            {
+                NodeAVL<T> *l = node->left;
+                node->left = l->right;
+                l->right = node;
+                node = l;
+            }
+            else
+            {
+                *tail = node;
+                tail = &node->right;
+                node = node->right;
+            }
+        }
+        return head;
+    }
+
+    /*Arma un arbol perfectamente balanceado con los n primeros nodos de la
+      lista (que avanza); recursion de profundidad log n*/
+    NodeAVL<T> *buildFromList(NodeAVL<T> *&list, size_t n)
+    {
+        if (n == 0)
+            return nullptr;
+        NodeAVL<T> *left = buildFromList(list, n / 2);
+        NodeAVL<T> *node = list;
+        list = list->right;
+        node->left = left;
+        node->right = buildFromList(list, n - n / 2 - 1);
+        updateHeight(node);
+        return node;
+    }
+
+    NodeAVL<T> *cloneTree(NodeAVL<T> *node)
     {
         if (!node)
-            return;
-        getPostOrder(node->left, ss);
-        getPostOrder(node->right, ss);
-        ss << node->data << " ";
+            return nullptr;
+        NodeAVL<T> *copy = createNode(node->data);
+        copy->height = node->height;
+        copy->count = node->count;
+        try
+        {
+            copy->left = cloneTree(node->left);
+            copy->right = cloneTree(node->right);
+        }
+        catch (...)
+        {
+            destroySubtree(copy);
+            throw;
+        }
+        return copy;
     }
 
     int height(NodeAVL<T> *node)
@@ -225,67 +1127,181 @@ private:
         return node->height;
     }
 
-    bool isBalanced(NodeAVL<T> *node)
+    /*Recorre en orden los nodos de un subarbol con una pila en linea*/
+    template <typename F>
+    static void visitInOrder(NodeAVL<T> *node, F &f)
     {
-        if (!node)
-            return true;
-        int bf = balancingFactor(node);
-        if (bf > 1 || bf < -1)
-            return false;
-        return isBalanced(node->left) && isBalanced(node->right);
+        NodeAVL<T> *stack[MaxPath];
+        int depth = 0;
+        while (node || depth)
+        {
+            while (node)
+            {
+                stack[depth++] = node;
+                node = node->left;
+            }
+            node = stack[--depth];
+            f(node);
+            node = node->right;
+        }
     }
 
-    int size(NodeAVL<T> *node)
+    /*Trozo de un recorrido paralelo: un subarbol entero o un nodo suelto de
+      los que quedan arriba del corte; first es la posicion en orden de su
+      primer elemento*/
+    struct Piece
     {
-        if (!node)
-            return 0;
-        return 1 + size(node->left) + size(node->right);
+        NodeAVL<T> *node;
+        bool whole;
+        size_t first;
+    };
+
+    // Menos nodos por trozo no paga lo que cuesta repartirlo
+    static const size_t MinGrain = 4096;
+
+    // Corta el subarbol en trozos de a lo sumo grain nodos, en orden
+    void cutPieces(NodeAVL<T> *node, size_t grain, size_t first, vector<Piece> &pieces)
+    {
+        while (node)
+        {
+            if (node->count <= grain)
+            {
+                pieces.push_back(Piece{node, true, first});
+                return;
+            }
+            cutPieces(node->left, grain, first, pieces);
+            first += count(node->left);
+            pieces.push_back(Piece{node, false, first++});
+            node = node->right;
+        }
     }
 
-    void remove(NodeAVL<T> *&node, T value)
+    // Unos 8 trozos por hilo para que el reparto dinamico empareje la carga
+    unsigned planPieces(unsigned threads, size_t grain, vector<Piece> &pieces)
     {
-        if (!node)
+        if (!threads)
+            threads = std::max(1u, thread::hardware_concurrency());
+        size_t n = count(root);
+        if (threads == 1)
+            grain = n;
+        else if (!grain)
+            grain = n / ((size_t)threads * 8) < MinGrain ? MinGrain : n / ((size_t)threads * 8);
+        cutPieces(root, std::max<size_t>(grain, 1), 0, pieces);
+        return threads;
+    }
+
+    // f(node, posicion en orden) por cada nodo del trozo
+    template <typename F>
+    static void visitPiece(const Piece &piece, F &f)
+    {
+        size_t pos = piece.first;
+        if (!piece.whole)
+        {
+            f(piece.node, pos);
             return;
+        }
+        auto visit = [&f, &pos](NodeAVL<T> *node) { f(node, pos++); };
+        visitInOrder(piece.node, visit);
+    }
 
-        if (value < node->data)
+    /*Reparte task(0..n-1) entre threads hilos (el que llama es uno): cada
+      hilo toma el siguiente indice de un contador atomico, asi un trozo lento
+      no deja a los demas ociosos. La primera excepcion corta el reparto y se
+      relanza aca*/
+    template <typename F>
+    static void runPieces(size_t n, unsigned threads, F task)
+    {
+        atomic<size_t> next(0);
+        atomic<bool> failed(false);
+        exception_ptr error;
+        mutex errorLock;
+        auto worker = [&]() {
+            size_t i;
+            while (!failed.load(memory_order_relaxed) && (i = next.fetch_add(1, memory_order_relaxed)) < n)
+            {
+                try
+                {
+                    task(i);
+                }
+                catch (...)
+                {
+                    lock_guard<mutex> lock(errorLock);
+                    if (!error)
+                        error = current_exception();
+                    failed.store(true, memory_order_relaxed);
+                }
+            }
+        };
+        vector<thread> pool;
+        size_t workers = std::min<size_t>(threads, n);
+        try
         {
-            remove(node->left, value);
+            for (size_t t = 1; t < workers; ++t)
+                pool.emplace_back(worker);
         }
-        else if (value > node->data)
+        catch (...)
         {
-            remove(node->right, value);
+            failed.store(true);
+            for (thread &t : pool)
+                t.join();
+            throw;
         }
-        else
+        worker();
+        for (thread &t : pool)
+            t.join();
+        if (error)
+            rethrow_exception(error);
+    }
+
+    size_t count(NodeAVL<T> *node)
+    {
+        return node ? node->count : 0;
+    }
+
+    // Las claves del subarbol deben estar en (lo, hi); devuelve la altura y el tamano reales
+    bool checkNode(NodeAVL<T> *node, const T *lo, const T *hi, int &h, size_t &c)
+    {
+        if (!node)
         {
-            if (!node->left && !node->right)
-            {
-                delete node;
-                node = nullptr;
-            }
-            else if (node->left && !node->right)
+            h = -1;
+            c = 0;
+            return true;
+        }
+        if ((lo && !(*lo < node->data)) || (hi && !(node->data < *hi)))
+            return false;
+        int lh, rh;
+        size_t lc, rc;
+        if (!checkNode(node->left, lo, &node->data, lh, lc) || !checkNode(node->right, &node->data, hi, rh, rc))
+            return false;
+        h = 1 + std::max(lh, rh);
+        c = 1 + lc + rc;
+        return node->height == h && node->count == c && lh - rh <= 1 && rh - lh <= 1;
+    }
+
+    // Cantidad de elementos < value (o <= value si inclusive)
+    size_t countBelow(const T &value, bool inclusive)
+    {
+        size_t below = 0;
+        NodeAVL<T> *current = root;
+        while (current)
+        {
+            if (value < current->data)
             {
-                NodeAVL<T> *temp = node;
-                node = node->left;
-                delete temp;
+                current = current->left;
             }
-            else if (!node->left && node->right)
+            else if (current->data < value || inclusive)
             {
-                NodeAVL<T> *temp = node;
-                node = node->right;
-                delete temp;
+                below += count(current->left) + 1;
+                if (!(current->data < value))
+                    return below;
+                current = current->right;
             }
             else
             {
-                NodeAVL<T> *pred = node->left;
-                while (pred->right)
-                    pred = pred->right;
-                node->data = pred->data;
-                remove(node->left, pred->data);
+                return below + count(current->left);
             }
         }
-
-        if (node)
-            balance(node);
+        return below;
     }
 
     void displayPretty(NodeAVL<T> *node, int depth)
@@ -312,7 +1328,8 @@ private:
         int leftHeight = (node->left) ? node->left->height : -1;
         int rightHeight = (node->right) ? node->right->height : -1;
         node->height = 1 + std::max(leftHeight, rightHeight);
-    } // Actualiza la altura de un nodo O(1)
+        node->count = 1 + count(node->left) + count(node->right);
+    } // Actualiza la altura y el tamano del subarbol de un nodo O(1)
 
     void balance(NodeAVL<T> *&node)
     {
@@ -321,19 +1338,23 @@ private:
 
         if (bf > 1)
         {
-            if (balancingFactor(node->left) < 0)
+            bool twice = balancingFactor(node->left) < 0; // caso LR
+            if (twice)
             {
                 left_rota(node->left);
             }
             right_rota(node);
+            DICT_STAT(++(twice ? statLR : statLL));
         }
         else if (bf < -1)
         {
-            if (balancingFactor(node->right) > 0)
+            bool twice = balancingFactor(node->right) > 0; // caso RL
+            if (twice)
             {
                 right_rota(node->right);
             }
             left_rota(node);
+            DICT_STAT(++(twice ? statRL : statRR));
         }
     } // Agoritmo principal que verifica el balanceo del nodo y aplica las rotaciones O(1)
 
@@ -1,6 +1,8 @@
 #ifndef AVL_ITERATOR_H
 #define AVL_ITERATOR_H
 
+#include <cstddef>
+#include <cstring>
 #include "AVL_Node.h"
 
 template <typename T>
@@ -13,107 +15,89 @@ public:
         BFS
     };
 
+    // Un AVL de altura h tiene al menos fib(h + 2) - 1 nodos: con 96 niveles
+    // alcanza para mas nodos de los que caben en memoria
+    static const int MaxDepth = 96;
+
 private:
     NodeAVL<T>* current;
     Type type;
 
-    // Pila personalizada
-    struct StackNode {
-        NodeAVL<T>* node;
-        bool visited;
-        StackNode* next;
-        StackNode(NodeAVL<T>* n, bool v = false, StackNode* nx = nullptr) : node(n), visited(v), next(nx) {}
-    };
-
-    StackNode* stackTop;
+    // Pila en linea (sin memoria dinamica): la altura del AVL la acota
+    NodeAVL<T>* stack[MaxDepth];
+    bool visited[MaxDepth];
+    int depth;
 
-    void stackPush(NodeAVL<T>* node, bool visited = false) {
-        stackTop = new StackNode(node, visited, stackTop);
+    void stackPush(NodeAVL<T>* node, bool v = false) {
+        stack[depth] = node;
+        visited[depth] = v;
+        depth++;
     }
 
-    StackNode* stackPop() {
-        if (!stackTop) return nullptr;
-        StackNode* top = stackTop;
-        stackTop = top->next;
-        return top;
+    NodeAVL<T>* stackPop() {
+        return stack[--depth];
     }
 
     bool stackEmpty() const {
-        return stackTop == nullptr;
+        return depth == 0;
     }
 
-    void clearStack() {
-        while (!stackEmpty()) {
-            delete stackPop();
-        }
-    }
-
-    void copyStack(StackNode* otherTop) {
-        if (!otherTop) return;
-        StackNode* nodes[1000];
-        int n = 0;
-        StackNode* temp = otherTop;
-        while (temp) {
-            nodes[n++] = temp;
-            temp = temp->next;
-        }
-        for (int i = n - 1; i >= 0; --i) {
-            stackPush(nodes[i]->node, nodes[i]->visited);
-        }
+    void copyStack(const AVLIterator& other) {
+        depth = other.depth;
+        memcpy(stack, other.stack, depth * sizeof(NodeAVL<T>*));
+        memcpy(visited, other.visited, depth * sizeof(bool));
     }
 
-    // Cola personalizada
-    struct QueueNode {
-        NodeAVL<T>* node;
-        QueueNode* next;
-        QueueNode(NodeAVL<T>* n) : node(n), next(nullptr) {}
-    };
-
-    QueueNode* queueFront = nullptr;
-    QueueNode* queueBack = nullptr;
+    // Cola circular para BFS: un solo buffer que crece al doble si se llena
+    NodeAVL<T>** queue;
+    size_t queueCap;
+    size_t queueHead;
+    size_t queueCount;
 
     void enqueue(NodeAVL<T>* node) {
-        QueueNode* newNode = new QueueNode(node);
-        if (!queueBack) {
-            queueFront = queueBack = newNode;
-        } else {
-            queueBack->next = newNode;
-            queueBack = newNode;
+        if (queueCount == queueCap) {
+            size_t newCap = queueCap ? queueCap * 2 : 16;
+            NodeAVL<T>** bigger = new NodeAVL<T>*[newCap];
+            for (size_t i = 0; i < queueCount; ++i)
+                bigger[i] = queue[(queueHead + i) & (queueCap - 1)];
+            delete[] queue;
+            queue = bigger;
+            queueCap = newCap;
+            queueHead = 0;
         }
+        queue[(queueHead + queueCount) & (queueCap - 1)] = node;
+        queueCount++;
     }
 
     NodeAVL<T>* dequeue() {
-        if (!queueFront) return nullptr;
-        QueueNode* temp = queueFront;
-        NodeAVL<T>* result = temp->node;
-        queueFront = queueFront->next;
-        if (!queueFront) queueBack = nullptr;
-        delete temp;
+        NodeAVL<T>* result = queue[queueHead];
+        queueHead = (queueHead + 1) & (queueCap - 1);
+        queueCount--;
         return result;
     }
 
     bool queueEmpty() const {
-        return queueFront == nullptr;
+        return queueCount == 0;
     }
 
     void clearQueue() {
-        while (!queueEmpty()) {
-            dequeue();
-        }
+        delete[] queue;
+        queue = nullptr;
+        queueCap = queueHead = queueCount = 0;
     }
 
-    void copyQueue(QueueNode* otherFront) {
-        queueFront = queueBack = nullptr;
-        QueueNode* temp = otherFront;
-        while (temp) {
-            enqueue(temp->node);
-            temp = temp->next;
-        }
+    void copyQueue(const AVLIterator& other) {
+        queue = nullptr;
+        queueCap = queueHead = queueCount = 0;
+        if (!other.queueCount) return;
+        queueCap = other.queueCap;
+        queue = new NodeAVL<T>*[queueCap];
+        for (size_t i = 0; i < other.queueCount; ++i)
+            queue[i] = other.queue[(other.queueHead + i) & (other.queueCap - 1)];
+        queueCount = other.queueCount;
     }
 
     void initInOrder(NodeAVL<T>* root) {
-        clearStack();
-        current = nullptr;
         while (root) {
             stackPush(root);
             root = root->left;
@@ -122,15 +106,11 @@ private:
     }
 
     void initPreOrder(NodeAVL<T>* root) {
-        clearStack();
-        current = nullptr;
         if (root) stackPush(root);
         ++(*this);
     }
 
     void initPostOrder(NodeAVL<T>* root) {
-        clearStack();
-        current = nullptr;
         while (root) {
             stackPush(root, false);
             root = root->left;
@@ -139,16 +119,14 @@ private:
     }
 
     void initBFS(NodeAVL<T>* root) {
-        clearQueue();
-        current = nullptr;
         if (root) enqueue(root);
         ++(*this);
     }
 
 public:
-    AVLIterator() : current(nullptr), stackTop(nullptr), queueFront(nullptr), queueBack(nullptr), type(InOrder) {}
+    AVLIterator() : current(nullptr), type(InOrder), depth(0), queue(nullptr), queueCap(0), queueHead(0), queueCount(0) {}
 
-    AVLIterator(NodeAVL<T>* root, Type _type) : current(nullptr), stackTop(nullptr), queueFront(nullptr), queueBack(nullptr), type(_type) {
+    AVLIterator(NodeAVL<T>* root, Type _type) : current(nullptr), type(_type), depth(0), queue(nullptr), queueCap(0), queueHead(0), queueCount(0) {
         switch (_type) {
             case InOrder: initInOrder(root); break;
             case PreOrder: initPreOrder(root); break;
@@ -157,33 +135,59 @@ public:
         }
     }
 
-    // Constructor de copia
-    AVLIterator(const AVLIterator& other) {
-        current = other.current;
-        type = other.type;
-        stackTop = nullptr;
-        queueFront = queueBack = nullptr;
-
-        if (type == BFS)
-            copyQueue(other.queueFront);
-        else
-            copyStack(other.stackTop);
+    // Iterador InOrder en el primer elemento >= key (> key si strict): la pila
+    // guarda los ancestros donde la busqueda bajo por la izquierda
+    static AVLIterator seek(NodeAVL<T>* root, const T& key, bool strict) {
+        AVLIterator it;
+        while (root) {
+            if (strict ? key < root->data : !(root->data < key)) {
+                it.stackPush(root);
+                root = root->left;
+            } else {
+                root = root->right;
+            }
+        }
+        ++it;
+        return it;
+    }
+
+    // Constructor de copia: solo copia la parte usada de la pila
+    AVLIterator(const AVLIterator& other) : current(other.current), type(other.type) {
+        copyStack(other);
+        copyQueue(other);
+    }
+
+    AVLIterator(AVLIterator&& other) : current(other.current), type(other.type),
+        queue(other.queue), queueCap(other.queueCap), queueHead(other.queueHead), queueCount(other.queueCount) {
+        copyStack(other);
+        other.queue = nullptr;
+        other.queueCap = other.queueHead = other.queueCount = 0;
     }
 
     // Operador de asignación
     AVLIterator& operator=(const AVLIterator& other) {
         if (this != &other) {
-            clearStack();
             clearQueue();
             current = other.current;
             type = other.type;
-            stackTop = nullptr;
-            queueFront = queueBack = nullptr;
+            copyStack(other);
+            copyQueue(other);
+        }
+        return *this;
+    }
 
-            if (type == BFS)
-                copyQueue(other.queueFront);
-            else
-                copyStack(other.stackTop);
+    AVLIterator& operator=(AVLIterator&& other) {
+        if (this != &other) {
+            clearQueue();
+            current = other.current;
+            type = other.type;
+            copyStack(other);
+            queue = other.queue;
+            queueCap = other.queueCap;
+            queueHead = other.queueHead;
+            queueCount = other.queueCount;
+            other.queue = nullptr;
+            other.queueCap = other.queueHead = other.queueCount = 0;
         }
         return *this;
     }
@@ -202,9 +206,7 @@ public:
                 current = nullptr;
                 return *this;
             }
-            StackNode* top = stackPop();
-            current = top->node;
-            delete top;
+            current = stackPop();
             NodeAVL<T>* temp = current->right;
             while (temp) {
                 stackPush(temp);
@@ -215,27 +217,20 @@ public:
                 current = nullptr;
                 return *this;
             }
-            StackNode* top = stackPop();
-            current = top->node;
-            delete top;
+            current = stackPop();
             if (current->right) stackPush(current->right);
             if (current->left) stackPush(current->left);
         } else if (type == PostOrder) {
             while (!stackEmpty()) {
-                StackNode* top = stackPop();
-                if (top->visited) {
-                    current = top->node;
-                    delete top;
+                if (visited[depth - 1]) {
+                    current = stackPop();
                     return *this;
-                } else {
-                    top->visited = true;
-                    stackPush(top->node, true);
-                    NodeAVL<T>* temp = top->node->right;
-                    while (temp) {
-                        stackPush(temp);
-                        temp = temp->left;
-                    }
-                    delete top;
+                }
+                visited[depth - 1] = true;
+                NodeAVL<T>* temp = stack[depth - 1]->right;
+                while (temp) {
+                    stackPush(temp);
+                    temp = temp->left;
                 }
             }
             current = nullptr;
@@ -252,7 +247,6 @@ public:
     }
 
     ~AVLIterator() {
-        clearStack();
         clearQueue();
     }
 
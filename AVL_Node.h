@@ -1,20 +1,20 @@
 #ifndef AVL_NODE_H
 #define AVL_NODE_H
 
+#include <cstddef>
+#include <utility>
+
 template <typename T>
 struct NodeAVL {
     T data;
     int height;
     NodeAVL* left; 
     NodeAVL* right;        
-    NodeAVL() : left(nullptr), right(nullptr), height(0) {}   
-    NodeAVL(T value) : data(value), left(nullptr), right(nullptr), height(0) {}   
-
-    void killSelf(){
-        if(left != nullptr) left->killSelf();
-        if(right != nullptr) right->killSelf();
-        delete this;
-    }
+    size_t count; // nodos del subarbol (este incluido)
+    NodeAVL() : height(0), left(nullptr), right(nullptr), count(1) {}   
+    // La clave se copia o se mueve una sola vez, directo a data
+    NodeAVL(const T& value) : data(value), height(0), left(nullptr), right(nullptr), count(1) {}
+    NodeAVL(T&& value) : data(std::move(value)), height(0), left(nullptr), right(nullptr), count(1) {}
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,334 @@
+#ifndef COMPACT_HASHTABLE_H
+#define COMPACT_HASHTABLE_H
+
+#include <iostream>
+#include <vector>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+using namespace std;
+
+// to_string para claves string (tambien lo declara HashTable.h)
+#ifndef DICT_STRING_TO_STRING
+#define DICT_STRING_TO_STRING
+namespace std
+{
+    inline std::string to_string(const std::string &s)
+    {
+        return s;
+    }
+}
+#endif
+
+/*
+ * Variante "compact dict" del HashTable:
+ *  - las entradas viven en un unico arreglo contiguo en orden de insercion
+ *  - un indice pequeño de direccionamiento abierto guarda offsets a ese arreglo
+ * remove() deja una lapida (tombstone) en la entrada y el arreglo de entradas
+ * se compacta periodicamente, por lo que el orden de insercion se conserva
+ * siempre. El iterador devuelve referencias a las entradas: recorrer la tabla
+ * es leer un arreglo contiguo sin copiar claves ni valores.
+ */
+template <typename TK, typename TV>
+class CompactHashTable;
+
+template <typename TK, typename TV>
+class CompactHashIterator
+{
+private:
+    typename CompactHashTable<TK, TV>::Entry *current;
+    typename CompactHashTable<TK, TV>::Entry *last;
+
+    void skipDead()
+    {
+        while (current != last && !current->alive)
+            ++current;
+    }
+
+public:
+    CompactHashIterator(typename CompactHashTable<TK, TV>::Entry *ptr,
+                        typename CompactHashTable<TK, TV>::Entry *end)
+        : current(ptr), last(end)
+    {
+        skipDead();
+    }
+
+    bool operator!=(const CompactHashIterator<TK, TV> &other) const
+    {
+        return this->current != other.current;
+    }
+
+    CompactHashIterator<TK, TV> &operator++()
+    { //++it
+        if (current != last)
+        {
+            ++current;
+            skipDead();
+        }
+        return *this;
+    }
+
+    const pair<TK, TV> &operator*() const
+    {
+        return current->item;
+    }
+
+    const pair<TK, TV> *operator->() const
+    {
+        return &current->item;
+    }
+};
+
+template <typename TK, typename TV>
+class CompactHashTable
+{
+public:
+    typedef CompactHashIterator<TK, TV> iterator;
+
+    struct Entry
+    {
+        size_t hash;
+        bool alive;
+        pair<TK, TV> item; // clave y valor juntos para que el iterador los devuelva por referencia
+
+        template <typename K, typename V>
+        Entry(size_t h, K &&k, V &&v) : hash(h), alive(true), item(std::forward<K>(k), std::forward<V>(v)) {}
+    };
+
+    iterator begin() { return iterator(entries, entries + used); } // Retorna el inicio del iterador
+    iterator end() { return iterator(entries + used, entries + used); } // Retorna el final del iterador
+
+private:
+    static const long long EMPTY = -1; // slot del indice nunca usado
+    static const long long DUMMY = -2; // slot del indice de una clave eliminada
+
+    Entry *entries;     // arreglo denso en orden de insercion
+    size_t entryCap;    // capacidad del arreglo de entradas
+    size_t used;        // entradas ocupadas (vivas + lapidas)
+    size_t size;        // total de elementos vivos
+    long long *index;   // direccionamiento abierto: offsets a entries
+    size_t indexMask;   // tamaño del indice - 1 (potencia de 2)
+
+    // Mismo mezclador que HashTable::hashKey: con sondeo lineal los bits bajos
+    // del std::hash crudo (la identidad para enteros) agrupan claves como i<<20
+    // en un solo slot y la busqueda se vuelve cuadratica
+    size_t hashKey(const TK &key) const
+    {
+        size_t h = std::hash<TK>()(key);
+        h ^= h >> 32;
+        h *= (size_t)0x9E3779B97F4A7C15ull;
+        return h ^ (h >> 29);
+    }
+
+    // Busca el slot del indice que apunta a key; -1 si no existe
+    long long lookupSlot(const TK &key, size_t h) const
+    {
+        size_t freeAt = 0;
+        return probe(key, h, freeAt);
+    }
+
+    // Un solo sondeo: retorna el slot de key o -1, y en freeAt deja el primer
+    // slot reutilizable (DUMMY o EMPTY) del recorrido para insertar sin volver a sondear
+    long long probe(const TK &key, size_t h, size_t &freeAt) const
+    {
+        size_t i = h & indexMask;
+        bool haveFree = false;
+        while (true)
+        {
+            long long ix = index[i];
+            if (ix == EMPTY)
+            {
+                if (!haveFree)
+                    freeAt = i;
+                return -1;
+            }
+            if (ix == DUMMY)
+            {
+                if (!haveFree)
+                {
+                    freeAt = i;
+                    haveFree = true;
+                }
+            }
+            else
+            {
+                const Entry &e = entries[ix];
+                if (e.hash == h && e.item.first == key)
+                    return (long long)i;
+            }
+            i = (i + 1) & indexMask;
+        }
+    }
+
+    // Agrega una entrada nueva; slot es el freeAt de probe() antes de crecer
+    template <typename K, typename V>
+    Entry &append(size_t h, size_t slot, K &&key, V &&value)
+    {
+        if (used == entryCap)
+        {
+            // Si hay muchas lapidas basta con compactar; si no, se duplica
+            resize(size * 2 < entryCap ? entryCap : entryCap * 2);
+            slot = freeSlot(h); // el indice se reconstruyo
+        }
+
+        new (&entries[used]) Entry(h, std::forward<K>(key), std::forward<V>(value));
+        index[slot] = (long long)used;
+        size++;
+        return entries[used++];
+    }
+
+    size_t freeSlot(size_t h) const
+    {
+        size_t i = h & indexMask;
+        while (index[i] >= 0)
+            i = (i + 1) & indexMask;
+        return i;
+    }
+
+    /*Reconstruye el arreglo denso (sin lapidas) y el indice para newCap entradas*/
+    void resize(size_t newCap)
+    {
+        size_t indexSize = 8;
+        while (indexSize * 2 < newCap * 3) // factor de carga del indice <= 2/3
+            indexSize *= 2;
+
+        // Se reserva todo antes de soltar nada: si falla la tabla no cambia
+        Entry *newEntries = static_cast<Entry *>(::operator new(sizeof(Entry) * newCap));
+        long long *newIndex;
+        try
+        {
+            newIndex = new long long[indexSize];
+        }
+        catch (...)
+        {
+            ::operator delete(newEntries);
+            throw;
+        }
+
+        size_t n = 0;
+        for (size_t i = 0; i < used; ++i)
+        {
+            if (entries[i].alive)
+                new (&newEntries[n++]) Entry(std::move(entries[i]));
+            entries[i].~Entry();
+        }
+        ::operator delete(entries);
+        entries = newEntries;
+
+        delete[] index;
+        index = newIndex;
+        for (size_t i = 0; i < indexSize; ++i)
+            index[i] = EMPTY;
+        indexMask = indexSize - 1;
+        entryCap = newCap;
+        used = n;
+        for (size_t i = 0; i < used; ++i)
+            index[freeSlot(entries[i].hash)] = (long long)i;
+    }
+
+public:
+    CompactHashTable(int _cap = 5) : entries(nullptr), entryCap(0), used(0), size(0), index(nullptr), indexMask(0)
+    {
+        resize(_cap > 0 ? (size_t)_cap : 1);
+    }
+
+    CompactHashTable(const CompactHashTable &) = delete;
+    CompactHashTable &operator=(const CompactHashTable &) = delete;
+
+    ~CompactHashTable()
+    {
+        for (size_t i = 0; i < used; ++i)
+            entries[i].~Entry();
+        ::operator delete(entries);
+        delete[] index;
+    }
+
+    void insert(TK key, TV value)
+    {
+        insert({std::move(key), std::move(value)});
+    }
+
+    void insert(pair<TK, TV> item)
+    {
+        size_t h = hashKey(item.first);
+        size_t freeAt = 0;
+        long long slot = probe(item.first, h, freeAt);
+        if (slot >= 0)
+        {
+            entries[index[slot]].item.second = std::move(item.second);
+            return;
+        }
+        append(h, freeAt, std::move(item.first), std::move(item.second));
+    }
+
+    TV &at(const TK &key)
+    {
+        size_t h = hashKey(key);
+        long long slot = lookupSlot(key, h);
+        if (slot < 0)
+            throw out_of_range("Key not found");
+        return entries[index[slot]].item.second;
+    }
+
+    /*Un solo sondeo: si la clave no existe se agrega en el slot libre que encontro*/
+    TV &operator[](TK key)
+    {
+        size_t h = hashKey(key);
+        size_t freeAt = 0;
+        long long slot = probe(key, h, freeAt);
+        if (slot >= 0)
+            return entries[index[slot]].item.second;
+        return append(h, freeAt, std::move(key), TV()).item.second;
+    }
+
+    bool find(const TK &key)
+    {
+        return lookupSlot(key, hashKey(key)) >= 0;
+    }
+
+    bool remove(const TK &key)
+    {
+        size_t h = hashKey(key);
+        long long slot = lookupSlot(key, h);
+        if (slot < 0)
+            return false;
+
+        entries[index[slot]].alive = false;
+        index[slot] = DUMMY;
+        size--;
+
+        // Compactacion periodica: cuando la mitad de las entradas son lapidas
+        if (used - size > 8 && used - size > size)
+            resize(entryCap);
+        return true;
+    }
+
+    int getSize()
+    {
+        return (int)size;
+    }
+
+    /*recorre el arreglo denso manteniendo el orden de insercion*/
+    vector<TK> getAllKeys()
+    {
+        vector<TK> keys;
+        keys.reserve(size);
+        for (size_t i = 0; i < used; ++i)
+            if (entries[i].alive)
+                keys.push_back(entries[i].item.first);
+        return keys;
+    }
+
+    vector<pair<TK, TV>> getAllElements()
+    {
+        vector<pair<TK, TV>> elements;
+        elements.reserve(size);
+        for (size_t i = 0; i < used; ++i)
+            if (entries[i].alive)
+                elements.push_back(entries[i].item);
+        return elements;
+    }
+};
+
+#endif
@@ -0,0 +1,520 @@
+#ifndef CONCURRENT_AVLTREE_H
+#define CONCURRENT_AVLTREE_H
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include "EpochReclaim.h"
+
+using namespace std;
+
+/*
+ * AVLTree para indices de casi solo lectura: find, successor, predecessor y
+ * forEach no toman locks. Cada nodo tiene una version (par = estable, impar =
+ * cambiando); un lector baja validando mano a mano que el padre no cambio
+ * mientras leia el enlace al hijo y reintenta desde la raiz si algo cambio.
+ * Los escritores se serializan con un mutex (como RcuHashTable) y suben la
+ * version de todo nodo cuyo rango de claves se achica: los que baja una
+ * rotacion, el nodo eliminado y el camino del predecesor que sube.
+ * Las claves no cambian nunca y los nodos eliminados se liberan por epocas.
+ */
+template <typename T>
+class ConcurrentAVLTree
+{
+private:
+    struct Node;
+
+    // Version y enlaces: la raiz cuelga del right de un Link centinela
+    struct Link
+    {
+        atomic<uint64_t> version;
+        atomic<Node *> left;
+        atomic<Node *> right;
+
+        Link() : version(0), left(nullptr), right(nullptr) {}
+    };
+
+    struct Node : Link
+    {
+        const T data;
+        int height; // solo la usa el escritor
+
+        template <typename K>
+        explicit Node(K &&value) : data(std::forward<K>(value)), height(0) {}
+    };
+
+    // Ver AVLIterator::MaxDepth
+    static const int MaxPath = 96;
+
+    Link holder;
+    atomic<size_t> size;
+    mutex writeLock;
+    RetireList retired;
+
+    static void deleteNode(void *p)
+    {
+        delete static_cast<Node *>(p);
+    }
+
+    /*Lectores*/
+    static uint64_t stableVersion(const Link *link)
+    {
+        unsigned spins = 0;
+        uint64_t v;
+        while ((v = link->version.load(memory_order_acquire)) & 1)
+        {
+            if (++spins % 64 == 0)
+                this_thread::yield();
+        }
+        return v;
+    }
+
+    static bool validate(const Link *link, uint64_t v)
+    {
+        atomic_thread_fence(memory_order_acquire);
+        return link->version.load(memory_order_relaxed) == v;
+    }
+
+    /*Baja por la clave validando mano a mano: se lee la version del hijo
+      y se confirma que el padre no cambio, asi el hijo seguia colgando de
+      el. Requiere un EpochGuard activo*/
+    Node *lookup(const T &key)
+    {
+    retry:
+        const Link *parent = &holder;
+        uint64_t pv = stableVersion(parent);
+        Node *node = parent->right.load(memory_order_acquire);
+        if (!validate(parent, pv))
+            goto retry;
+        while (node)
+        {
+            uint64_t nv = stableVersion(node);
+            if (!validate(parent, pv))
+                goto retry;
+            bool goLeft = key < node->data;
+            if (!goLeft && !(node->data < key))
+                return node;
+            Node *child = (goLeft ? node->left : node->right).load(memory_order_acquire);
+            if (!validate(node, nv))
+                goto retry;
+            parent = node;
+            pv = nv;
+            node = child;
+        }
+        return nullptr;
+    }
+
+    /*Bajada que nunca se detiene: upper (primer elemento > key) guarda los
+      giros a la izquierda; si no (ultimo elemento < key) los giros a la derecha.
+      Con key == nullptr baja siempre a la izquierda (minimo)*/
+    Node *bound(const T *key, bool upper)
+    {
+    retry:
+        Node *result = nullptr;
+        const Link *parent = &holder;
+        uint64_t pv = stableVersion(parent);
+        Node *node = parent->right.load(memory_order_acquire);
+        if (!validate(parent, pv))
+            goto retry;
+        while (node)
+        {
+            uint64_t nv = stableVersion(node);
+            if (!validate(parent, pv))
+                goto retry;
+            bool goLeft = !key || (upper ? *key < node->data : !(node->data < *key));
+            Node *child = (goLeft ? node->left : node->right).load(memory_order_acquire);
+            if (!validate(node, nv))
+                goto retry;
+            if (goLeft == upper)
+                result = node;
+            parent = node;
+            pv = nv;
+            node = child;
+        }
+        return result;
+    }
+
+    // Pendiente de forEach: nodo al que se bajo por la izquierda y su version
+    struct Frame
+    {
+        Node *node;
+        uint64_t version;
+    };
+
+    /*Pila de forEach para seguir despues de key: los nodos > key del camino
+      de busqueda, el tope es el sucesor. Con key == nullptr, el camino al minimo*/
+    int seek(const T *key, Frame stack[])
+    {
+    retry:
+        int depth = 0;
+        const Link *parent = &holder;
+        uint64_t pv = stableVersion(parent);
+        Node *node = parent->right.load(memory_order_acquire);
+        if (!validate(parent, pv))
+            goto retry;
+        while (node)
+        {
+            uint64_t nv = stableVersion(node);
+            if (!validate(parent, pv))
+                goto retry;
+            bool goLeft = !key || *key < node->data;
+            Node *child = (goLeft ? node->left : node->right).load(memory_order_acquire);
+            if (!validate(node, nv))
+                goto retry;
+            if (goLeft)
+                stack[depth++] = {node, nv};
+            parent = node;
+            pv = nv;
+            node = child;
+        }
+        return depth;
+    }
+
+    /*Apila el camino al minimo de node, hijo de parent leido con version pv;
+      false si algo cambio en el camino (hay que volver a seek)*/
+    static bool pushLeft(const Link *parent, uint64_t pv, Node *node, Frame stack[], int &depth)
+    {
+        while (node)
+        {
+            uint64_t nv = stableVersion(node);
+            if (!validate(parent, pv) || depth == MaxPath)
+                return false;
+            Node *child = node->left.load(memory_order_acquire);
+            if (!validate(node, nv))
+                return false;
+            stack[depth++] = {node, nv};
+            parent = node;
+            pv = nv;
+            node = child;
+        }
+        return true;
+    }
+
+    /*Escritor (con writeLock tomado)*/
+    static void beginChange(Link *link)
+    {
+        link->version.store(link->version.load(memory_order_relaxed) + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+    }
+
+    static void endChange(Link *link)
+    {
+        link->version.store(link->version.load(memory_order_relaxed) + 1, memory_order_release);
+    }
+
+    static int height(Node *node)
+    {
+        return node ? node->height : -1;
+    }
+
+    static void updateHeight(Node *node)
+    {
+        node->height = 1 + std::max(height(node->left.load(memory_order_relaxed)),
+                                    height(node->right.load(memory_order_relaxed)));
+    }
+
+    static int balancingFactor(Node *node)
+    {
+        return height(node->left.load(memory_order_relaxed)) - height(node->right.load(memory_order_relaxed));
+    }
+
+    // node baja y su hijo izquierdo sube; link es el enlace de owner a node
+    static void right_rota(Link *owner, atomic<Node *> &link)
+    {
+        Node *node = link.load(memory_order_relaxed);
+        Node *newRoot = node->left.load(memory_order_relaxed);
+        beginChange(owner);
+        beginChange(node);
+        beginChange(newRoot);
+        node->left.store(newRoot->right.load(memory_order_relaxed), memory_order_relaxed);
+        newRoot->right.store(node, memory_order_relaxed);
+        link.store(newRoot, memory_order_relaxed);
+        endChange(newRoot);
+        endChange(node);
+        endChange(owner);
+        updateHeight(node);
+        updateHeight(newRoot);
+    }
+
+    static void left_rota(Link *owner, atomic<Node *> &link)
+    {
+        Node *node = link.load(memory_order_relaxed);
+        Node *newRoot = node->right.load(memory_order_relaxed);
+        beginChange(owner);
+        beginChange(node);
+        beginChange(newRoot);
+        node->right.store(newRoot->left.load(memory_order_relaxed), memory_order_relaxed);
+        newRoot->left.store(node, memory_order_relaxed);
+        link.store(newRoot, memory_order_relaxed);
+        endChange(newRoot);
+        endChange(node);
+        endChange(owner);
+        updateHeight(node);
+        updateHeight(newRoot);
+    }
+
+    static void balance(Link *owner, atomic<Node *> &link)
+    {
+        Node *node = link.load(memory_order_relaxed);
+        updateHeight(node);
+        int bf = balancingFactor(node);
+        if (bf > 1)
+        {
+            if (balancingFactor(node->left.load(memory_order_relaxed)) < 0)
+                left_rota(node, node->left);
+            right_rota(owner, link);
+        }
+        else if (bf < -1)
+        {
+            if (balancingFactor(node->right.load(memory_order_relaxed)) > 0)
+                right_rota(node, node->right);
+            left_rota(owner, link);
+        }
+    }
+
+    // Rebalancea de abajo hacia arriba hasta que una altura no cambie
+    static void retrace(Link *owners[], atomic<Node *> *links[], int n)
+    {
+        while (n > 0)
+        {
+            --n;
+            int oldHeight = links[n]->load(memory_order_relaxed)->height;
+            balance(owners[n], *links[n]);
+            if (links[n]->load(memory_order_relaxed)->height == oldHeight)
+                return;
+        }
+    }
+
+    template <typename K>
+    bool insertKey(K &&value)
+    {
+        lock_guard<mutex> lock(writeLock);
+        Link *owners[MaxPath];
+        atomic<Node *> *links[MaxPath];
+        int n = 0;
+        Link *owner = &holder;
+        atomic<Node *> *link = &holder.right;
+        while (Node *current = link->load(memory_order_relaxed))
+        {
+            owners[n] = owner;
+            links[n] = link;
+            n++;
+            owner = current;
+            if (value < current->data)
+                link = &current->left;
+            else if (current->data < value)
+                link = &current->right;
+            else
+                return false;
+        }
+        // Un lector que vio el enlace vacio antes de esto no encontro la clave
+        link->store(new Node(std::forward<K>(value)), memory_order_release);
+        size.fetch_add(1, memory_order_relaxed);
+        retrace(owners, links, n);
+        return true;
+    }
+
+public:
+    ConcurrentAVLTree() : size(0) {}
+
+    ConcurrentAVLTree(const ConcurrentAVLTree &) = delete;
+    ConcurrentAVLTree &operator=(const ConcurrentAVLTree &) = delete;
+
+    /*No debe haber lectores activos al destruir el arbol*/
+    ~ConcurrentAVLTree()
+    {
+        retired.drain();
+        Node *node = holder.right.load(memory_order_relaxed);
+        while (node) // mismas rotaciones que AVLTree::destroyTree
+        {
+            Node *l = node->left.load(memory_order_relaxed);
+            if (l)
+            {
+                node->left.store(l->right.load(memory_order_relaxed), memory_order_relaxed);
+                l->right.store(node, memory_order_relaxed);
+                node = l;
+            }
+            else
+            {
+                Node *next = node->right.load(memory_order_relaxed);
+                delete node;
+                node = next;
+            }
+        }
+    }
+
+    bool insert(const T &value) // false si ya estaba
+    {
+        return insertKey(value);
+    }
+
+    bool insert(T &&value)
+    {
+        return insertKey(std::move(value));
+    }
+
+    bool remove(const T &value) // Use el predecesor cuando el nodo tiene dos hijos
+    {
+        lock_guard<mutex> lock(writeLock);
+        Link *owners[MaxPath];
+        atomic<Node *> *links[MaxPath];
+        int n = 0;
+        Link *owner = &holder;
+        atomic<Node *> *link = &holder.right;
+        Node *node;
+        while ((node = link->load(memory_order_relaxed)))
+        {
+            if (value < node->data || node->data < value)
+            {
+                owners[n] = owner;
+                links[n] = link;
+                n++;
+                owner = node;
+                link = value < node->data ? &node->left : &node->right;
+            }
+            else
+            {
+                break;
+            }
+        }
+        if (!node)
+            return false;
+
+        Node *left = node->left.load(memory_order_relaxed);
+        Node *right = node->right.load(memory_order_relaxed);
+        if (left && right)
+        {
+            // El predecesor sube al lugar del nodo: el rango de todo el camino
+            // entre ambos se achica, asi que todos cambian de version
+            owners[n] = owner;
+            links[n] = link;
+            n++;
+            int below = n;
+            Link *predOwner = node;
+            atomic<Node *> *predLink = &node->left;
+            Node *pred = left;
+            while (Node *next = pred->right.load(memory_order_relaxed))
+            {
+                owners[n] = predOwner;
+                links[n] = predLink;
+                n++;
+                predOwner = pred;
+                predLink = &pred->right;
+                pred = next;
+            }
+
+            beginChange(owner);
+            beginChange(node);
+            for (int i = below + 1; i < n; ++i)
+                beginChange(owners[i]);
+            if (predOwner != node)
+                beginChange(predOwner);
+            beginChange(pred);
+
+            predLink->store(pred->left.load(memory_order_relaxed), memory_order_relaxed);
+            pred->left.store(node->left.load(memory_order_relaxed), memory_order_relaxed);
+            pred->right.store(right, memory_order_relaxed);
+            pred->height = node->height;
+            link->store(pred, memory_order_relaxed);
+
+            endChange(pred);
+            if (predOwner != node)
+                endChange(predOwner);
+            for (int i = n - 1; i > below; --i)
+                endChange(owners[i]);
+            endChange(node);
+            endChange(owner);
+
+            if (below < n)
+            {
+                owners[below] = pred;
+                links[below] = &pred->left;
+            }
+        }
+        else
+        {
+            beginChange(owner);
+            beginChange(node);
+            link->store(left ? left : right, memory_order_relaxed);
+            endChange(node);
+            endChange(owner);
+        }
+        size.fetch_sub(1, memory_order_relaxed);
+        retired.retire(node, &deleteNode);
+        retrace(owners, links, n);
+        return true;
+    }
+
+    bool find(const T &value)
+    {
+        EpochGuard guard;
+        return lookup(value) != nullptr;
+    }
+
+    bool successor(const T &value, T &out) // Primer elemento > value
+    {
+        EpochGuard guard;
+        Node *succ = bound(&value, true);
+        if (!succ)
+            return false;
+        out = succ->data;
+        return true;
+    }
+
+    bool predecessor(const T &value, T &out) // Ultimo elemento < value
+    {
+        EpochGuard guard;
+        Node *pred = bound(&value, false);
+        if (!pred)
+            return false;
+        out = pred->data;
+        return true;
+    }
+
+    size_t getSize()
+    {
+        return size.load(memory_order_relaxed);
+    }
+
+    /*Recorre en orden sin locks con una pila, O(n): ve las claves que estaban
+      al momento de pasar por ellas. Si un nodo de la pila cambio de version
+      la pila se reconstruye desde la ultima clave entregada (O(log n)).
+      El EpochGuard dura todo el recorrido*/
+    template <typename F>
+    void forEach(F f)
+    {
+        EpochGuard guard;
+        Frame stack[MaxPath];
+        T last;
+        bool started = false;
+        int depth = seek(nullptr, stack);
+        while (depth > 0)
+        {
+            Frame top = stack[--depth];
+            Node *right = top.node->right.load(memory_order_acquire);
+            if (!validate(top.node, top.version))
+            {
+                depth = seek(started ? &last : nullptr, stack);
+                continue;
+            }
+            last = top.node->data;
+            started = true;
+            f(last);
+            if (!pushLeft(top.node, top.version, right, stack, depth))
+                depth = seek(&last, stack);
+        }
+    }
+
+    vector<T> getAll()
+    {
+        vector<T> values;
+        forEach([&](const T &v)
+                { values.push_back(v); });
+        return values;
+    }
+
+};
+
+#endif
@@ -0,0 +1,202 @@
+#ifndef CONCURRENT_HASHTABLE_H
+#define CONCURRENT_HASHTABLE_H
+
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+#include <cstdint>
+#include "HashTable.h"
+
+/*
+ * HashTable concurrente por shards: el espacio de claves se reparte entre
+ * varios HashTable (cadenas por bucket), cada uno con su propio mutex, asi
+ * los escritores de shards distintos no compiten.
+ * Cada entrada guarda un numero de secuencia global; getAllKeys(),
+ * getAllElements() y forEach() devuelven el orden de insercion global.
+ */
+template <typename TK, typename TV>
+class ConcurrentHashTable
+{
+private:
+    struct Entry
+    {
+        uint64_t seq; // 0 = recien creada por operator[]
+        TV value;
+
+        Entry() : seq(0), value() {}
+    };
+
+    typedef HashTable<TK, Entry> Table;
+
+    // Cada shard en su propia linea de cache para no compartir el mutex
+    struct alignas(64) Shard
+    {
+        mutex lock;
+        Table table;
+    };
+
+public:
+    typedef typename Table::key_view key_view;
+
+private:
+    Shard *shards;
+    size_t shardBits;
+    atomic<uint64_t> nextSeq;
+
+    // Bits altos del hash: el HashTable interno usa los bajos para sus buckets
+    Shard &shardFor(key_view key)
+    {
+        size_t h = std::hash<typename decay<key_view>::type>()(key);
+        h *= (size_t)0x9E3779B97F4A7C15ull;
+        return shards[shardBits ? h >> (sizeof(size_t) * 8 - shardBits) : 0];
+    }
+
+    size_t shardCount() const
+    {
+        return (size_t)1 << shardBits;
+    }
+
+    struct Item
+    {
+        uint64_t seq;
+        TK key;
+        TV value;
+    };
+
+    // Copia consistente de todas las entradas (todos los shards bloqueados)
+    vector<Item> snapshot()
+    {
+        for (size_t i = 0; i < shardCount(); ++i)
+            shards[i].lock.lock();
+        vector<Item> items;
+        size_t total = 0;
+        for (size_t i = 0; i < shardCount(); ++i)
+            total += shards[i].table.getSize();
+        items.reserve(total);
+        for (size_t i = 0; i < shardCount(); ++i)
+        {
+            for (auto it = shards[i].table.begin(); it != shards[i].table.end(); ++it)
+            {
+                pair<TK, Entry> kv = *it;
+                items.push_back({kv.second.seq, std::move(kv.first), std::move(kv.second.value)});
+            }
+        }
+        for (size_t i = shardCount(); i-- > 0;)
+            shards[i].lock.unlock();
+
+        // orden global de insercion
+        sort(items.begin(), items.end(), [](const Item &a, const Item &b)
+             { return a.seq < b.seq; });
+        return items;
+    }
+
+public:
+    ConcurrentHashTable(size_t shardHint = 64) : shardBits(0), nextSeq(1)
+    {
+        while (((size_t)1 << shardBits) < shardHint)
+            shardBits++;
+        shards = new Shard[shardCount()];
+    }
+
+    ConcurrentHashTable(const ConcurrentHashTable &) = delete;
+    ConcurrentHashTable &operator=(const ConcurrentHashTable &) = delete;
+
+    ~ConcurrentHashTable()
+    {
+        delete[] shards;
+    }
+
+    /*Inserta o sobrescribe; una clave existente conserva su posicion*/
+    template <typename K, typename V>
+    void insert(K &&key, V &&value)
+    {
+        Shard &s = shardFor(key);
+        lock_guard<mutex> guard(s.lock);
+        Entry &e = s.table[std::forward<K>(key)];
+        if (e.seq == 0)
+            e.seq = nextSeq.fetch_add(1, memory_order_relaxed);
+        e.value = std::forward<V>(value);
+    }
+
+    void insert(const pair<TK, TV> &item)
+    {
+        insert(item.first, item.second);
+    }
+
+    bool find(key_view key)
+    {
+        Shard &s = shardFor(key);
+        lock_guard<mutex> guard(s.lock);
+        return s.table.find(key);
+    }
+
+    /*Copia el valor en out; no se entregan referencias fuera del lock.
+      Un solo sondeo bajo el lock*/
+    bool get(key_view key, TV &out)
+    {
+        Shard &s = shardFor(key);
+        lock_guard<mutex> guard(s.lock);
+        Entry *e = s.table.find_ptr(key);
+        if (!e)
+            return false;
+        out = e->value;
+        return true;
+    }
+
+    TV at(key_view key)
+    {
+        TV out;
+        if (!get(key, out))
+            throw out_of_range("Key not found");
+        return out;
+    }
+
+    bool remove(key_view key)
+    {
+        Shard &s = shardFor(key);
+        lock_guard<mutex> guard(s.lock);
+        return s.table.remove(key);
+    }
+
+    size_t getSize()
+    {
+        size_t total = 0;
+        for (size_t i = 0; i < shardCount(); ++i)
+        {
+            lock_guard<mutex> guard(shards[i].lock);
+            total += shards[i].table.getSize();
+        }
+        return total;
+    }
+
+    /*itera sobre una copia consistente manteniendo el orden de insercion global*/
+    template <typename F>
+    void forEach(F f)
+    {
+        vector<Item> items = snapshot();
+        for (Item &item : items)
+            f(item.key, item.value);
+    }
+
+    vector<TK> getAllKeys()
+    {
+        vector<Item> items = snapshot();
+        vector<TK> keys;
+        keys.reserve(items.size());
+        for (Item &item : items)
+            keys.push_back(std::move(item.key));
+        return keys;
+    }
+
+    vector<pair<TK, TV>> getAllElements()
+    {
+        vector<Item> items = snapshot();
+        vector<pair<TK, TV>> elements;
+        elements.reserve(items.size());
+        for (Item &item : items)
+            elements.emplace_back(std::move(item.key), std::move(item.value));
+        return elements;
+    }
+};
+
+#endif
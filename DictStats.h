@@ -0,0 +1,106 @@
+#ifndef DICT_STATS_H
+#define DICT_STATS_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <chrono>
+#include <functional>
+
+using namespace std;
+
+/*
+ * Estadisticas de los caminos calientes de HashTable y AVLTree. Solo existen
+ * compilando con -DDICT_STATS (opcion DICT_STATS de CMake): sin la macro los
+ * contadores y stats() no se compilan y el costo es cero.
+ */
+#ifdef DICT_STATS
+#define DICT_STAT(stmt) stmt
+#else
+#define DICT_STAT(stmt)
+#endif
+
+// Suma a total los segundos que vive el objeto
+class StatTimer
+{
+private:
+    double &total;
+    chrono::steady_clock::time_point start;
+
+public:
+    explicit StatTimer(double &t) : total(t), start(chrono::steady_clock::now()) {}
+
+    ~StatTimer()
+    {
+        total += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+};
+
+struct HashTableStats
+{
+    size_t size = 0;
+    size_t buckets = 0;
+    double loadFactor = 0;
+    vector<size_t> chainHistogram; // [k] = buckets con k nodos
+    size_t maxChain = 0;
+    size_t lookups = 0;      // llamadas a find/at y claves de find_many
+    double avgProbe = 0;     // nodos comparados por busqueda
+    size_t rehashes = 0;     // llamadas a rehashing()
+    double rehashSeconds = 0; // rehashing() mas la migracion incremental
+    size_t bytes = 0;        // buckets + nodos + memoria de los string
+};
+
+struct AVLTreeStats
+{
+    size_t size = 0;
+    int height = -1;
+    size_t rotationsLL = 0; // rotacion simple a la derecha
+    size_t rotationsRR = 0; // rotacion simple a la izquierda
+    size_t rotationsLR = 0; // doble: izquierda en el hijo, derecha en el nodo
+    size_t rotationsRL = 0;
+    size_t searches = 0;    // llamadas a find
+    double avgSearchDepth = 0; // nodos visitados por busqueda
+    size_t bytes = 0;       // nodos + memoria de los string
+};
+
+inline ostream &operator<<(ostream &os, const HashTableStats &s)
+{
+    os << "size " << s.size << ", buckets " << s.buckets << ", load " << s.loadFactor
+       << ", max chain " << s.maxChain << "\nchains:";
+    for (size_t k = 0; k < s.chainHistogram.size(); ++k)
+        os << ' ' << k << ':' << s.chainHistogram[k];
+    os << "\nlookups " << s.lookups << ", avg probe " << s.avgProbe
+       << "\nrehashes " << s.rehashes << " (" << s.rehashSeconds << " s)"
+       << "\nbytes " << s.bytes << '\n';
+    return os;
+}
+
+inline ostream &operator<<(ostream &os, const AVLTreeStats &s)
+{
+    os << "size " << s.size << ", height " << s.height
+       << "\nrotations LL " << s.rotationsLL << ", RR " << s.rotationsRR
+       << ", LR " << s.rotationsLR << ", RL " << s.rotationsRL
+       << "\nsearches " << s.searches << ", avg depth " << s.avgSearchDepth
+       << "\nbytes " << s.bytes << '\n';
+    return os;
+}
+
+// Memoria fuera del objeto: solo los string que no usan el buffer interno
+template <typename T>
+size_t heapBytes(const T &)
+{
+    return 0;
+}
+
+inline size_t heapBytes(const string &s)
+{
+    const char *data = s.data();
+    const char *self = reinterpret_cast<const char *>(&s);
+    less<const char *> before;
+    if (!before(data, self) && before(data, self + sizeof(string)))
+        return 0;
+    return s.capacity() + 1;
+}
+
+#endif
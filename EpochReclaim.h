@@ -0,0 +1,240 @@
+#ifndef EPOCH_RECLAIM_H
+#define EPOCH_RECLAIM_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+
+/*
+ * Reclamacion por epocas (EBR) para estructuras con lectores sin locks.
+ * Un lector anuncia la epoca global en su slot mientras dura un EpochGuard;
+ * un escritor que desenlaza un nodo lo "retira" con la epoca actual y solo
+ * lo libera cuando ningun lector activo anuncia una epoca <= a la del retiro.
+ */
+class EpochDomain
+{
+public:
+    static const size_t MaxThreads = 256;
+
+private:
+    struct alignas(64) Slot
+    {
+        std::atomic<uint64_t> epoch; // 0 = sin lector activo
+        std::atomic<bool> used;
+        unsigned depth;              // guards anidados del mismo hilo
+    };
+
+    Slot slots[MaxThreads];
+    std::atomic<uint64_t> globalEpoch;
+
+    static EpochDomain domain;
+
+    EpochDomain() : globalEpoch(1)
+    {
+        for (size_t i = 0; i < MaxThreads; ++i)
+        {
+            slots[i].epoch.store(0, std::memory_order_relaxed);
+            slots[i].used.store(false, std::memory_order_relaxed);
+            slots[i].depth = 0;
+        }
+    }
+
+    // Registro del hilo: toma un slot libre la primera vez y lo suelta al salir
+    struct Registration
+    {
+        Slot *slot;
+
+        Registration() : slot(nullptr) {}
+
+        ~Registration()
+        {
+            if (slot)
+            {
+                slot->epoch.store(0, std::memory_order_release);
+                slot->used.store(false, std::memory_order_release);
+            }
+        }
+    };
+
+    // Camino rapido: un puntero thread_local trivial (sin guardas de init)
+    Slot &mySlot()
+    {
+        static thread_local Slot *cached = nullptr;
+        if (!cached)
+            cached = &registerThread();
+        return *cached;
+    }
+
+    Slot &registerThread()
+    {
+        static thread_local Registration reg;
+        if (!reg.slot)
+        {
+            for (size_t i = 0; i < MaxThreads; ++i)
+            {
+                bool expected = false;
+                if (!slots[i].used.load(std::memory_order_relaxed) &&
+                    slots[i].used.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+                {
+                    slots[i].depth = 0;
+                    reg.slot = &slots[i];
+                    break;
+                }
+            }
+            if (!reg.slot)
+                throw std::runtime_error("EpochDomain: too many threads");
+        }
+        return *reg.slot;
+    }
+
+public:
+    static EpochDomain &instance()
+    {
+        return domain;
+    }
+
+    void enter()
+    {
+        Slot &s = mySlot();
+        if (s.depth++ > 0)
+            return;
+        // Se vuelve a leer la epoca tras anunciarla: si un escritor avanzo
+        // entre medio pudo no ver el anuncio, y se anuncia la nueva
+        uint64_t e = globalEpoch.load(std::memory_order_relaxed);
+        while (true)
+        {
+            s.epoch.store(e, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            uint64_t again = globalEpoch.load(std::memory_order_relaxed);
+            if (again == e)
+                break;
+            e = again;
+        }
+    }
+
+    void leave()
+    {
+        Slot &s = mySlot();
+        if (--s.depth == 0)
+            s.epoch.store(0, std::memory_order_release);
+    }
+
+    uint64_t current()
+    {
+        return globalEpoch.load(std::memory_order_seq_cst);
+    }
+
+    /*Avanza la epoca y retorna la menor epoca anunciada por un lector activo:
+      lo retirado con una epoca menor ya no es alcanzable por nadie*/
+    uint64_t advance()
+    {
+        uint64_t minEpoch = globalEpoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+        for (size_t i = 0; i < MaxThreads; ++i)
+        {
+            if (!slots[i].used.load(std::memory_order_acquire))
+                continue;
+            uint64_t e = slots[i].epoch.load(std::memory_order_seq_cst);
+            if (e != 0 && e < minEpoch)
+                minEpoch = e;
+        }
+        return minEpoch;
+    }
+};
+
+// inline: una sola instancia aunque el header se incluya en varias unidades
+inline EpochDomain EpochDomain::domain;
+
+/*Marca una seccion de lectura sin locks (RAII)*/
+class EpochGuard
+{
+public:
+    EpochGuard()
+    {
+        EpochDomain::instance().enter();
+    }
+
+    ~EpochGuard()
+    {
+        EpochDomain::instance().leave();
+    }
+
+    EpochGuard(const EpochGuard &) = delete;
+    EpochGuard &operator=(const EpochGuard &) = delete;
+};
+
+/*
+ * Lista de objetos retirados de un contenedor. No es thread-safe: la usa
+ * el escritor, que ya esta serializado por el lock del contenedor.
+ */
+class RetireList
+{
+private:
+    struct Retired
+    {
+        void *ptr;
+        void (*deleter)(void *);
+        uint64_t epoch;
+        Retired *next;
+    };
+
+    Retired *head;
+    size_t sinceCollect;
+
+    static const size_t collectEvery = 64;
+
+public:
+    RetireList() : head(nullptr), sinceCollect(0) {}
+
+    RetireList(const RetireList &) = delete;
+    RetireList &operator=(const RetireList &) = delete;
+
+    ~RetireList()
+    {
+        drain();
+    }
+
+    void retire(void *ptr, void (*deleter)(void *))
+    {
+        head = new Retired{ptr, deleter, EpochDomain::instance().current(), head};
+        if (++sinceCollect >= collectEvery)
+            collect();
+    }
+
+    /*Libera lo que ningun lector puede estar viendo*/
+    void collect()
+    {
+        sinceCollect = 0;
+        uint64_t safe = EpochDomain::instance().advance();
+        Retired **link = &head;
+        while (*link)
+        {
+            Retired *r = *link;
+            if (r->epoch < safe)
+            {
+                *link = r->next;
+                r->deleter(r->ptr);
+                delete r;
+            }
+            else
+            {
+                link = &r->next;
+            }
+        }
+    }
+
+    /*Libera todo; solo cuando ya no quedan lectores (p. ej. en el destructor)*/
+    void drain()
+    {
+        while (head)
+        {
+            Retired *r = head;
+            head = r->next;
+            r->deleter(r->ptr);
+            delete r;
+        }
+        sinceCollect = 0;
+    }
+};
+
+#endif
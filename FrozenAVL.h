@@ -0,0 +1,148 @@
+#ifndef FROZEN_AVL_H
+#define FROZEN_AVL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include "Prefetch.h"
+
+using namespace std;
+
+/*
+ * Copia inmutable de un AVLTree (ver AVLTree::freeze) en orden de Eytzinger:
+ * el arbol completo se guarda por niveles en un arreglo (hijos de k en 2k y
+ * 2k + 1), asi la busqueda no sigue punteros, no tiene saltos dependientes
+ * de la comparacion y puede traer por adelantado los niveles de abajo.
+ */
+template <typename T>
+class FrozenAVL
+{
+private:
+    T *keys; // keys[1..n]; keys[0] no se usa
+    size_t n;
+
+    // 16 elementos por linea de 64 bytes si T es de 4 bytes: el prefetch de
+    // 16k trae los 16 descendientes de k cuatro niveles mas abajo
+    static const size_t prefetchAhead = 16;
+
+    template <typename It>
+    void fill(It &it, size_t k)
+    {
+        if (k > n)
+            return;
+        fill(it, 2 * k);
+        keys[k] = *it;
+        ++it;
+        fill(it, 2 * k + 1);
+    }
+
+    // k >> (unos al final de k + 1): deshace los pasos a la derecha del final
+    static size_t climbRight(size_t k)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return k >> (__builtin_ctzll(~(unsigned long long)k) + 1);
+#else
+        while (k & 1)
+            k >>= 1;
+        return k >> 1;
+#endif
+    }
+
+    // k >> (ceros al final de k + 1): deshace los pasos a la izquierda del final
+    static size_t climbLeft(size_t k)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return k >> (__builtin_ctzll((unsigned long long)k) + 1);
+#else
+        while (k && !(k & 1))
+            k >>= 1;
+        return k >> 1;
+#endif
+    }
+
+    // Baja hasta pasar una hoja: cada paso es 2k + (keys[k] < key) o
+    // 2k + (keys[k] <= key) si strict, sin ramas
+    size_t descend(const T &key, bool strict) const
+    {
+        size_t k = 1;
+        if (strict)
+        {
+            while (k <= n)
+            {
+                DICT_PREFETCH(keys + std::min(k * prefetchAhead, n));
+                k = 2 * k + !(key < keys[k]);
+            }
+        }
+        else
+        {
+            while (k <= n)
+            {
+                DICT_PREFETCH(keys + std::min(k * prefetchAhead, n));
+                k = 2 * k + (keys[k] < key);
+            }
+        }
+        return k;
+    }
+
+public:
+    /*Toma n elementos ordenados desde first*/
+    template <typename It>
+    FrozenAVL(It first, size_t count) : keys(new T[count + 1]), n(count)
+    {
+        fill(first, 1);
+    }
+
+    FrozenAVL(FrozenAVL &&other) : keys(other.keys), n(other.n)
+    {
+        other.keys = nullptr;
+        other.n = 0;
+    }
+
+    FrozenAVL(const FrozenAVL &) = delete;
+    FrozenAVL &operator=(const FrozenAVL &) = delete;
+
+    ~FrozenAVL()
+    {
+        delete[] keys;
+    }
+
+    size_t size() const
+    {
+        return n;
+    }
+
+    bool find(const T &key) const // O(log n)
+    {
+        size_t k = climbRight(descend(key, false));
+        return k && !(key < keys[k]);
+    }
+
+    bool lower_bound(const T &key, T &out) const // Primer elemento >= key
+    {
+        size_t k = climbRight(descend(key, false));
+        if (!k)
+            return false;
+        out = keys[k];
+        return true;
+    }
+
+    bool successor(const T &key, T &out) const // Primer elemento > key
+    {
+        size_t k = climbRight(descend(key, true));
+        if (!k)
+            return false;
+        out = keys[k];
+        return true;
+    }
+
+    bool predecessor(const T &key, T &out) const // Ultimo elemento < key
+    {
+        size_t k = climbLeft(descend(key, false));
+        if (!k)
+            return false;
+        out = keys[k];
+        return true;
+    }
+};
+
+#endif
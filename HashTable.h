@@ -1,12 +1,43 @@
+#ifndef HASHTABLE_H
+#define HASHTABLE_H
+
 #include <iostream>
 #include <vector>
+#include <stdexcept>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <memory>
+#include "NodePool.h"
+#include "Prefetch.h"
+#include "HashTableSnapshot.h"
+#include "DictStats.h"
+#include <iterator>
 using namespace std;
 
-const int maxColision = 3;
-
 template <typename TK, typename TV>
-class HashTable;
+struct HashNode
+{
+    TK key;
+    TV value;
+    size_t hashCode; // hash completo de key, se reutiliza en rehashing()
+    HashNode *nextBucket;
+    HashNode *prevOrdered;
+    HashNode *nextOrdered;
+
+    template <typename K, typename... Args>
+    HashNode(size_t h, K &&k, Args &&...args)
+        : key(std::forward<K>(k)), value(std::forward<Args>(args)...), hashCode(h),
+          nextBucket(nullptr),
+          prevOrdered(nullptr),
+          nextOrdered(nullptr) {}
+};
 
+// to_string para claves string (tambien lo declara CompactHashTable.h)
+#ifndef DICT_STRING_TO_STRING
+#define DICT_STRING_TO_STRING
 namespace std
 {
     inline std::string to_string(const std::string &s)
@@ -14,6 +45,7 @@ namespace std
         return s;
     }
 }
+#endif
 
 // itera sobre el hashtable manteniendo el orden de insercion
 template <typename TK, typename TV>
@@ -21,10 +53,10 @@ class HashIterator
 {
 private:
     // TODO
-    typename HashTable<TK, TV>::NodeHT *current;
+    HashNode<TK, TV> *current;
 
 public:
-    HashIterator(typename HashTable<TK, TV>::NodeHT *ptr) : current(ptr) {}
+    HashIterator(HashNode<TK, TV> *ptr) : current(ptr) {}
 
     HashIterator<TK, TV> &operator=(HashIterator<TK, TV> other)
     {
@@ -50,7 +82,7 @@ public:
     }
 };
 
-template <typename TK, typename TV>
+template <typename TK, typename TV, typename Alloc = std::allocator<pair<const TK, TV>>>
 class HashTable
 {
 public:
@@ -59,150 +91,265 @@ public:
     iterator begin() { return iterator(headOrdered); } // Retorna el inicio del iterador
     iterator end() { return iterator(nullptr); }       // Retorna el final del iterador
 
-    struct NodeHT
-    {
-        TK key;
-        TV value;
-        NodeHT *nextBucket;
-        NodeHT *prevOrdered;
-        NodeHT *nextOrdered;
+    // Tipo con el que se buscan las claves: para claves string es string_view,
+    // asi at/find/remove aceptan const char* o buffers sin crear un std::string
+    typedef typename conditional<is_same<TK, string>::value, string_view, const TK &>::type key_view;
 
-        NodeHT(const TK &k, const TV &v)
-            : key(k), value(v),
-              nextBucket(nullptr),
-              prevOrdered(nullptr),
-              nextOrdered(nullptr) {}
-    };
+    typedef HashNode<TK, TV> NodeHT;
 
 private:
-    int capacity; // capacidad del hash table
-    int size;     // total de elementos
+    typedef typename allocator_traits<Alloc>::template rebind_alloc<NodeHT> NodeAlloc;
+    typedef allocator_traits<NodeAlloc> NodeTraits;
+
+    size_t capacity; // capacidad del hash table (siempre potencia de 2)
+    size_t size;     // total de elementos
     // TODO: completar los demas atributo
     NodeHT **buckets;
     NodeHT *headOrdered;
     NodeHT *tailOrdered;
+    float maxLoad; // factor de carga maximo antes de duplicar capacity
+
+    // Rehashing incremental: mientras oldBuckets != nullptr conviven los dos
+    // arrays; los buckets viejos [0, migratePos) ya se movieron al nuevo
+    bool incremental;
+    NodeHT **oldBuckets;
+    size_t oldCapacity;
+    size_t migratePos;
+
+    NodeAlloc nodeAlloc;
+
+#ifdef DICT_STATS
+    size_t statLookups = 0;
+    size_t statProbes = 0;
+    size_t statRehashes = 0;
+    double statRehashSeconds = 0;
+#endif
+
+    // std::hash<int> es la identidad: se mezclan los bits altos para que
+    // la mascara de hash() no dependa solo de los bits bajos de la clave
+    // std::hash<string_view> y std::hash<string> coinciden por estandar
+    size_t hashKey(key_view key)
+    {
+        size_t h = std::hash<typename decay<key_view>::type>()(key);
+        h ^= h >> 32;
+        h *= (size_t)0x9E3779B97F4A7C15ull;
+        return h ^ (h >> 29);
+    }
 
-    int hash(TK key)
+    size_t hash(size_t hashCode)
     {
-        return std::hash<TK>()(key) % capacity;
+        return hashCode & (capacity - 1);
     }
 
-public:
-    HashTable(int _cap = 5) : capacity(_cap), size(0)
+    // Bucket donde vive (o viviria) la clave: si su bucket viejo aun no se
+    // migro sigue en oldBuckets, asi cada busqueda recorre una sola cadena
+    NodeHT **bucketFor(size_t hashCode)
     {
-        // TODO
-        buckets = new NodeHT *[capacity];
-        for (int i = 0; i < capacity; ++i)
+        if (oldBuckets)
         {
-            buckets[i] = nullptr;
+            size_t oldIdx = hashCode & (oldCapacity - 1);
+            if (oldIdx >= migratePos)
+                return &oldBuckets[oldIdx];
         }
+        return &buckets[hash(hashCode)];
+    }
+
+    // calloc entrega memoria ya en cero (paginas nuevas para arrays grandes),
+    // asi crear el array no es un recorrido O(capacity) dentro de un insert
+    static NodeHT **allocBuckets(size_t n)
+    {
+        NodeHT **b = static_cast<NodeHT **>(calloc(n, sizeof(NodeHT *)));
+        if (!b)
+            throw bad_alloc();
+        return b;
+    }
+
+    static void freeBuckets(NodeHT **b)
+    {
+        if (b != emptyBuckets())
+            free(b);
+    }
+
+    // Array de un bucket vacio compartido por las tablas movidas: moverse no
+    // reserva memoria y el primer insert lo reemplaza por uno propio. Nunca
+    // se escribe
+    static NodeHT **emptyBuckets()
+    {
+        static NodeHT *empty[1] = {nullptr};
+        return empty;
+    }
+
+    // Menor potencia de 2 con capacidad para n elementos sin pasar maxLoad
+    size_t bucketsFor(size_t n)
+    {
+        size_t cap = 1;
+        while ((double)cap * maxLoad < (double)n)
+            cap <<= 1;
+        return cap;
+    }
+
+public:
+    HashTable(size_t _cap = 5, const Alloc &alloc = Alloc())
+        : capacity(1), size(0), maxLoad(1.0f),
+          incremental(false), oldBuckets(nullptr), oldCapacity(0), migratePos(0),
+          nodeAlloc(alloc)
+    {
+        while (capacity < _cap)
+            capacity <<= 1;
+        buckets = allocBuckets(capacity);
         headOrdered = nullptr;
         tailOrdered = nullptr;
     }
 
-    void insert(TK key, TV value)
+    HashTable(const HashTable &other)
+        : HashTable(other.capacity, NodeTraits::select_on_container_copy_construction(other.nodeAlloc))
     {
-        insert({key, value});
+        maxLoad = other.maxLoad;
+        incremental = other.incremental;
+        for (NodeHT *current = other.headOrdered; current; current = current->nextOrdered)
+            insert(current->key, current->value);
     }
 
-    void insert(pair<TK, TV> item)
+    HashTable(HashTable &&other) noexcept(is_nothrow_copy_constructible<NodeAlloc>::value)
+        : capacity(other.capacity), size(other.size), buckets(other.buckets),
+          headOrdered(other.headOrdered), tailOrdered(other.tailOrdered), maxLoad(other.maxLoad),
+          incremental(other.incremental), oldBuckets(other.oldBuckets), oldCapacity(other.oldCapacity),
+          migratePos(other.migratePos), nodeAlloc(other.nodeAlloc)
     {
-        int idx = hash(item.first);
-        NodeHT *current = buckets[idx];
-        int count = 0;
+        other.capacity = 1;
+        other.size = 0;
+        other.buckets = emptyBuckets();
+        other.headOrdered = other.tailOrdered = nullptr;
+        other.oldBuckets = nullptr;
+    }
 
-        while (current)
-        {
-            if (current->key == item.first)
-            {
-                current->value = item.second;
-                return;
-            }
-            current = current->nextBucket;
-            count++;
-        }
+    HashTable &operator=(HashTable other)
+    {
+        swap(other);
+        return *this;
+    }
 
-        if (count >= maxColision)
-        {
-            rehashing();
-            insert(item);
-            return;
-        }
+    void swap(HashTable &other)
+    {
+        std::swap(capacity, other.capacity);
+        std::swap(size, other.size);
+        std::swap(buckets, other.buckets);
+        std::swap(headOrdered, other.headOrdered);
+        std::swap(tailOrdered, other.tailOrdered);
+        std::swap(maxLoad, other.maxLoad);
+        std::swap(incremental, other.incremental);
+        std::swap(oldBuckets, other.oldBuckets);
+        std::swap(oldCapacity, other.oldCapacity);
+        std::swap(migratePos, other.migratePos);
+        std::swap(nodeAlloc, other.nodeAlloc);
+    }
 
-        NodeHT *newNode = new NodeHT(item.first, item.second);
-        newNode->nextBucket = buckets[idx];
-        buckets[idx] = newNode;
+    ~HashTable()
+    {
+        releaseNodes();
+        freeBuckets(oldBuckets);
+        freeBuckets(buckets);
+    }
 
-        if (!headOrdered)
-        {
-            headOrdered = tailOrdered = newNode;
-        }
-        else
-        {
-            tailOrdered->nextOrdered = newNode;
-            newNode->prevOrdered = tailOrdered;
-            tailOrdered = newNode;
-        }
+    void clear()
+    {
+        finishRehash();
+        releaseNodes();
+        if (buckets != emptyBuckets())
+            for (size_t i = 0; i < capacity; ++i)
+                buckets[i] = nullptr;
+        headOrdered = tailOrdered = nullptr;
+        size = 0;
+    }
 
-        size++;
+    template <typename K, typename V>
+    void insert(K &&key, V &&value)
+    {
+        insert_or_assign(std::forward<K>(key), std::forward<V>(value));
     }
 
-    TV &at(TK key)
+    void insert(const pair<TK, TV> &item)
     {
-        int idx = hash(key);
-        NodeHT *current = buckets[idx];
-        while (current)
-        {
-            if (current->key == key)
-                return current->value;
-            current = current->nextBucket;
-        }
-        throw out_of_range("Key not found");
+        insert_or_assign(item.first, item.second);
     }
 
-    TV &operator[](TK key)
+    void insert(pair<TK, TV> &&item)
     {
-        int idx = hash(key);
-        NodeHT *current = buckets[idx];
+        insert_or_assign(std::move(item.first), std::move(item.second));
+    }
 
-        while (current)
-        {
-            if (current->key == key)
-                return current->value;
-            current = current->nextBucket;
-        }
+    /*Inserta key con TV(args...) solo si no existe; no modifica un valor existente*/
+    template <typename K, typename... Args>
+    pair<iterator, bool> try_emplace(K &&key, Args &&...args)
+    {
+        pair<NodeHT *, bool> r = emplaceKey(std::forward<K>(key), std::forward<Args>(args)...);
+        return {iterator(r.first), r.second};
+    }
 
-        insert(key, TV());
-        return at(key);
+    template <typename... Args>
+    pair<iterator, bool> emplace(Args &&...args)
+    {
+        pair<TK, TV> item(std::forward<Args>(args)...);
+        return try_emplace(std::move(item.first), std::move(item.second));
     }
 
-    bool find(TK key)
+    /*Inserta o sobrescribe; retorna true en second si la clave era nueva*/
+    template <typename K, typename M>
+    pair<iterator, bool> insert_or_assign(K &&key, M &&obj)
     {
-        int idx = hash(key);
-        NodeHT *current = buckets[idx];
-        while (current)
-        {
-            if (current->key == key)
-                return true;
-            current = current->nextBucket;
-        }
-        return false;
+        // emplaceKey solo consume key/obj cuando crea el nodo
+        pair<NodeHT *, bool> r = emplaceKey(std::forward<K>(key), std::forward<M>(obj));
+        if (!r.second)
+            r.first->value = std::forward<M>(obj);
+        return {iterator(r.first), r.second};
+    }
+
+    TV &at(key_view key)
+    {
+        rehashStep();
+        NodeHT *node = findNode(key, hashKey(key));
+        if (!node)
+            throw out_of_range("Key not found");
+        return node->value;
     }
 
-    bool remove(TK key)
+    /*Un solo sondeo: si la clave no existe se crea con TV() en el mismo bucket*/
+    template <typename K>
+    TV &operator[](K &&key)
     {
-        int idx = hash(key);
-        NodeHT *current = buckets[idx];
+        return emplaceKey(std::forward<K>(key)).first->value;
+    }
+
+    bool find(key_view key)
+    {
+        rehashStep();
+        return findNode(key, hashKey(key)) != nullptr;
+    }
+
+    /*Como find() pero entrega el valor: nullptr si la clave no existe*/
+    TV *find_ptr(key_view key)
+    {
+        rehashStep();
+        NodeHT *node = findNode(key, hashKey(key));
+        return node ? &node->value : nullptr;
+    }
+
+    bool remove(key_view key)
+    {
+        rehashStep();
+        size_t h = hashKey(key);
+        NodeHT **bucket = bucketFor(h);
+        NodeHT *current = *bucket;
         NodeHT *prev = nullptr;
 
         while (current)
         {
-            if (current->key == key)
+            if (current->hashCode == h && current->key == key)
             {
                 if (prev)
                     prev->nextBucket = current->nextBucket;
                 else
-                    buckets[idx] = current->nextBucket;
+                    *bucket = current->nextBucket;
 
                 if (current->prevOrdered)
                     current->prevOrdered->nextOrdered = current->nextOrdered;
@@ -214,7 +361,7 @@ public:
                 else
                     tailOrdered = current->prevOrdered;
 
-                delete current;
+                destroyNode(current);
                 size--;
                 return true;
             }
@@ -224,11 +371,172 @@ public:
         return false;
     }
 
-    int getSize()
+    /*Busca un lote de claves solapando los fallos de cache: primero calcula
+      los hashes y prefetchea los buckets, luego recorre las cadenas de forma
+      intercalada. out[i] apunta al valor o es nullptr; retorna los aciertos*/
+    template <typename K>
+    size_t find_many(const K *keys, size_t n, TV **out)
+    {
+        size_t found = 0;
+        NodeHT **heads[batchSize];
+        NodeHT *current[batchSize];
+        size_t hashes[batchSize];
+
+        for (size_t base = 0; base < n; base += batchSize)
+        {
+            size_t m = n - base < batchSize ? n - base : batchSize;
+            rehashStep();
+            DICT_STAT(statLookups += m);
+            for (size_t i = 0; i < m; ++i)
+            {
+                hashes[i] = hashKey(keys[base + i]);
+                heads[i] = bucketFor(hashes[i]);
+                DICT_PREFETCH(heads[i]);
+            }
+            for (size_t i = 0; i < m; ++i)
+            {
+                current[i] = *heads[i];
+                if (current[i])
+                    DICT_PREFETCH(current[i]);
+            }
+
+            size_t pending = m;
+            for (size_t i = 0; i < m; ++i)
+            {
+                out[base + i] = nullptr;
+                if (!current[i])
+                    pending--;
+            }
+            while (pending)
+            {
+                for (size_t i = 0; i < m; ++i)
+                {
+                    NodeHT *node = current[i];
+                    if (!node)
+                        continue;
+                    DICT_STAT(statProbes++);
+                    if (node->hashCode == hashes[i] && node->key == keys[base + i])
+                    {
+                        out[base + i] = &node->value;
+                        current[i] = nullptr;
+                        found++;
+                        pending--;
+                        continue;
+                    }
+                    current[i] = node->nextBucket;
+                    if (current[i])
+                        DICT_PREFETCH(current[i]);
+                    else
+                        pending--;
+                }
+            }
+        }
+        return found;
+    }
+
+    vector<TV *> find_many(const vector<TK> &keys)
+    {
+        vector<TV *> out(keys.size());
+        find_many(keys.data(), keys.size(), out.data());
+        return out;
+    }
+
+    /*Inserta (o sobrescribe) un rango de pares: si el rango se puede recorrer
+      dos veces reserva de una vez y prefetchea los buckets de cada lote*/
+    template <typename It>
+    void insert_many(It first, It last)
+    {
+        typedef typename iterator_traits<It>::iterator_category category;
+        if constexpr (!is_base_of<forward_iterator_tag, category>::value)
+        {
+            for (; first != last; ++first)
+                insert_or_assign(first->first, first->second);
+        }
+        else
+        {
+            reserve(size + (size_t)std::distance(first, last));
+
+            size_t hashes[batchSize];
+            It batch[batchSize];
+            while (first != last)
+            {
+                rehashStep();
+                size_t m = 0;
+                for (; m < batchSize && first != last; ++m, ++first)
+                {
+                    batch[m] = first;
+                    hashes[m] = hashKey(first->first);
+                    DICT_PREFETCH(bucketFor(hashes[m]));
+                }
+                for (size_t i = 0; i < m; ++i)
+                {
+                    pair<NodeHT *, bool> r = emplaceHashed(hashes[i], batch[i]->first, batch[i]->second);
+                    if (!r.second)
+                        r.first->value = batch[i]->second;
+                }
+            }
+        }
+    }
+
+    size_t getSize()
     {
         return size;
     }
 
+    size_t bucket_count()
+    {
+        return capacity;
+    }
+
+    float load_factor()
+    {
+        return (float)size / (float)capacity;
+    }
+
+    float max_load_factor()
+    {
+        return maxLoad;
+    }
+
+    void max_load_factor(float ml)
+    {
+        if (!(ml > 0.0f))
+            throw invalid_argument("max_load_factor must be positive");
+        maxLoad = ml;
+        if ((double)size > (double)capacity * maxLoad)
+            rehashing(bucketsFor(size));
+    }
+
+    /*Con el modo incremental cada insert/find/at/remove migra unos pocos
+      buckets en vez de mover toda la tabla en una sola llamada*/
+    void incremental_rehash(bool on)
+    {
+        incremental = on;
+        if (!on)
+            finishRehash();
+    }
+
+    bool incremental_rehash()
+    {
+        return incremental;
+    }
+
+    /*Reserva buckets para n elementos: insertar hasta n no provoca rehashing*/
+    void reserve(size_t n)
+    {
+        size_t cap = bucketsFor(n);
+        if (cap > capacity)
+            rehashing(cap);
+    }
+
+    /*Reduce capacity a la menor potencia de 2 que respeta maxLoad*/
+    void shrink_to_fit()
+    {
+        size_t cap = bucketsFor(size);
+        if (cap < capacity)
+            rehashing(cap);
+    }
+
     /*itera sobre el hashtable manteniendo el orden de insercion*/
     vector<TK> getAllKeys()
     {
@@ -254,49 +562,251 @@ public:
         return elements;
     }
 
+    /*Guarda la tabla en formato binario para abrirla con MappedHashTable
+      (TK y TV deben ser std::string o trivialmente copiables)*/
+    void save(const string &path)
+    {
+        writeSnapshot<TK, TV>(path, size, [&](auto emit)
+                              {
+                                  for (NodeHT *current = headOrdered; current; current = current->nextOrdered)
+                                      emit(current->key, current->value); });
+    }
+
+#ifdef DICT_STATS
+    /*Largo de las cadenas, sondeos por find/at, rehashing y memoria.
+      O(capacity + n); los contadores se acumulan desde reset_stats()*/
+    HashTableStats stats()
+    {
+        HashTableStats s;
+        s.size = size;
+        s.buckets = capacity;
+        s.loadFactor = load_factor();
+        countChains(buckets, 0, capacity, s);
+        if (oldBuckets) // rehashing incremental en curso
+            countChains(oldBuckets, migratePos, oldCapacity, s);
+        s.lookups = statLookups;
+        s.avgProbe = statLookups ? (double)statProbes / (double)statLookups : 0;
+        s.rehashes = statRehashes;
+        s.rehashSeconds = statRehashSeconds;
+        s.bytes = (capacity + (oldBuckets ? oldCapacity : 0)) * sizeof(NodeHT *) + size * sizeof(NodeHT);
+        if constexpr (is_same<TK, string>::value || is_same<TV, string>::value)
+        {
+            for (NodeHT *current = headOrdered; current; current = current->nextOrdered)
+                s.bytes += heapBytes(current->key) + heapBytes(current->value);
+        }
+        return s;
+    }
+
+    void reset_stats()
+    {
+        statLookups = statProbes = statRehashes = 0;
+        statRehashSeconds = 0;
+    }
+#endif
+
 private:
-    /*Si una lista colisionada excede maxColision, redimensionar el array*/
-    void rehashing()
+#ifdef DICT_STATS
+    static void countChains(NodeHT **array, size_t from, size_t to, HashTableStats &s)
     {
-        int oldCapacity = capacity;
-        capacity *= 2;
-        NodeHT **oldBuckets = buckets;
-        buckets = new NodeHT *[capacity];
+        for (size_t i = from; i < to; ++i)
+        {
+            size_t len = 0;
+            for (NodeHT *current = array[i]; current; current = current->nextBucket)
+                len++;
+            if (len >= s.chainHistogram.size())
+                s.chainHistogram.resize(len + 1);
+            s.chainHistogram[len]++;
+            if (len > s.maxChain)
+                s.maxChain = len;
+        }
+    }
+#endif
 
-        for (int i = 0; i < capacity; ++i)
-            buckets[i] = nullptr;
+    /*Libera todos los nodos; con un PoolAllocator propio la memoria se
+      devuelve por chunks y, si los nodos son triviales, sin recorrerlos*/
+    void releaseNodes()
+    {
+        bool bulk = poolExclusive(nodeAlloc);
+        if (!bulk || !is_trivially_destructible<NodeHT>::value)
+        {
+            NodeHT *current = headOrdered;
+            while (current)
+            {
+                NodeHT *next = current->nextOrdered;
+                if (bulk)
+                    NodeTraits::destroy(nodeAlloc, current);
+                else
+                    destroyNode(current);
+                current = next;
+            }
+        }
+        if (bulk)
+            poolRelease(nodeAlloc);
+    }
 
-        NodeHT *current = headOrdered;
-        headOrdered = nullptr;
-        tailOrdered = nullptr;
-        size = 0;
+    template <typename... Args>
+    NodeHT *createNode(Args &&...args)
+    {
+        NodeHT *node = NodeTraits::allocate(nodeAlloc, 1);
+        try
+        {
+            NodeTraits::construct(nodeAlloc, node, std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            NodeTraits::deallocate(nodeAlloc, node, 1);
+            throw;
+        }
+        return node;
+    }
 
-        while (current)
+    void destroyNode(NodeHT *node)
+    {
+        NodeTraits::destroy(nodeAlloc, node);
+        NodeTraits::deallocate(nodeAlloc, node, 1);
+    }
+
+    NodeHT *findNode(key_view key, size_t h)
+    {
+        DICT_STAT(statLookups++);
+        for (NodeHT *current = *bucketFor(h); current; current = current->nextBucket)
         {
-            NodeHT *next = current->nextOrdered;
-            current->nextBucket = nullptr;
-            current->nextOrdered = nullptr;
-            current->prevOrdered = nullptr;
+            DICT_STAT(statProbes++);
+            if (current->hashCode == h && current->key == key)
+                return current;
+        }
+        return nullptr;
+    }
+
+    /*Busca key y, si no existe, crea el nodo con TV(args...) en el mismo sondeo*/
+    template <typename K, typename... Args>
+    pair<NodeHT *, bool> emplaceKey(K &&key, Args &&...args)
+    {
+        rehashStep();
+        return emplaceHashed(hashKey(key), std::forward<K>(key), std::forward<Args>(args)...);
+    }
+
+    template <typename K, typename... Args>
+    pair<NodeHT *, bool> emplaceHashed(size_t h, K &&key, Args &&...args)
+    {
+        NodeHT **bucket = bucketFor(h);
+        for (NodeHT *current = *bucket; current; current = current->nextBucket)
+        {
+            if (current->hashCode == h && current->key == key)
+                return {current, false};
+        }
+
+        // Se crece solo por factor de carga (un cluster no duplica la tabla)
+        // o para dejar el array compartido de una tabla movida
+        if ((double)(size + 1) > (double)capacity * maxLoad || buckets == emptyBuckets())
+        {
+            rehashing(capacity * 2);
+            bucket = bucketFor(h);
+        }
+
+        NodeHT *newNode = createNode(h, std::forward<K>(key), std::forward<Args>(args)...);
+        newNode->nextBucket = *bucket;
+        *bucket = newNode;
+
+        if (!headOrdered)
+        {
+            headOrdered = tailOrdered = newNode;
+        }
+        else
+        {
+            tailOrdered->nextOrdered = newNode;
+            newNode->prevOrdered = tailOrdered;
+            tailOrdered = newNode;
+        }
+
+        size++;
+        return {newNode, true};
+    }
+
+    static const size_t batchSize = 16; // claves en vuelo en find_many/insert_many
+
+    static const size_t rehashStepBuckets = 2;  // buckets no vacios migrados por operacion
+    static const size_t rehashStepScan = 16;    // buckets vacios revisados como maximo
+
+    /*Redimensiona el array de buckets; el orden de insercion no se toca*/
+    void rehashing(size_t newCapacity)
+    {
+        finishRehash(); // se mide aparte
+        DICT_STAT(statRehashes++);
+        DICT_STAT(StatTimer timer(statRehashSeconds));
 
-            int idx = hash(current->key);
+        NodeHT **fresh = allocBuckets(newCapacity); // si falla la tabla no cambia
+        NodeHT **previous = buckets;
+        size_t previousCapacity = capacity;
+        capacity = newCapacity;
+        buckets = fresh;
+
+        if (incremental && previous != emptyBuckets())
+        {
+            oldBuckets = previous;
+            oldCapacity = previousCapacity;
+            migratePos = 0;
+            return;
+        }
+
+        // Se recorre en orden de insercion para que cada cadena conserve
+        // el mismo orden relativo que tendria insertando uno por uno
+        for (NodeHT *current = headOrdered; current; current = current->nextOrdered)
+        {
+            size_t idx = hash(current->hashCode);
             current->nextBucket = buckets[idx];
             buckets[idx] = current;
+        }
 
-            if (!headOrdered)
-            {
-                headOrdered = tailOrdered = current;
-            }
-            else
-            {
-                tailOrdered->nextOrdered = current;
-                current->prevOrdered = tailOrdered;
-                tailOrdered = current;
-            }
+        freeBuckets(previous);
+    }
 
-            size++;
+    /*Mueve la cadena del bucket viejo migratePos al array nuevo*/
+    void migrateBucket()
+    {
+        NodeHT *current = oldBuckets[migratePos];
+        while (current)
+        {
+            NodeHT *next = current->nextBucket;
+            size_t idx = hash(current->hashCode);
+            current->nextBucket = buckets[idx];
+            buckets[idx] = current;
             current = next;
         }
+        oldBuckets[migratePos++] = nullptr;
+    }
+
+    /*Trabajo acotado de migracion: O(1) por operacion*/
+    void rehashStep()
+    {
+        if (!oldBuckets)
+            return;
+        DICT_STAT(StatTimer timer(statRehashSeconds));
+        size_t moved = 0;
+        for (size_t scanned = 0; scanned < rehashStepScan && migratePos < oldCapacity; ++scanned)
+        {
+            bool empty = oldBuckets[migratePos] == nullptr;
+            migrateBucket();
+            if (!empty && ++moved == rehashStepBuckets)
+                break;
+        }
+        if (migratePos == oldCapacity)
+        {
+            freeBuckets(oldBuckets);
+            oldBuckets = nullptr;
+        }
+    }
 
-        delete[] oldBuckets;
+    void finishRehash()
+    {
+        if (!oldBuckets)
+            return;
+        DICT_STAT(StatTimer timer(statRehashSeconds));
+        while (migratePos < oldCapacity)
+            migrateBucket();
+        freeBuckets(oldBuckets);
+        oldBuckets = nullptr;
     }
 };
+
+#endif
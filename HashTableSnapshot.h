@@ -0,0 +1,225 @@
+#ifndef HASHTABLE_SNAPSHOT_H
+#define HASHTABLE_SNAPSHOT_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+using namespace std;
+
+/*
+ * Formato binario de un HashTable (ver HashTable::save y MappedHashTable):
+ *
+ *   SnapshotHeader
+ *   entries[count]   en orden de insercion: hash | campo clave | campo valor
+ *   index[indexSize] direccionamiento abierto lineal: numero de entrada + 1 (0 = vacio)
+ *   blob             bytes de las claves/valores string
+ *
+ * Cada campo ocupa un multiplo de 8 bytes: los tipos trivialmente copiables
+ * se guardan tal cual y los string como (offset, longitud) dentro del blob.
+ * El hash es propio y estable entre procesos (std::hash no lo garantiza).
+ */
+struct SnapshotHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t endianTag;
+    uint32_t keyKind;   // 0 = trivial, 1 = string
+    uint32_t valueKind;
+    uint32_t keySize;   // sizeof del tipo trivial, 0 para string
+    uint32_t valueSize;
+    uint64_t count;
+    uint64_t indexSize; // potencia de 2
+    uint64_t entriesOffset;
+    uint64_t indexOffset;
+    uint64_t blobOffset;
+    uint64_t fileSize;
+};
+
+static const char snapshotMagic[8] = {'D', 'I', 'C', 'T', 'S', 'N', 'P', '1'};
+static const uint32_t snapshotVersion = 1;
+static const uint32_t snapshotEndianTag = 0x01020304;
+
+inline uint64_t snapshotHashBytes(const void *data, size_t len)
+{
+    const unsigned char *p = static_cast<const unsigned char *>(data);
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ (uint64_t)len;
+    while (len >= 8)
+    {
+        uint64_t w;
+        memcpy(&w, p, 8);
+        h = (h ^ w) * 0xFF51AFD7ED558CCDull;
+        h ^= h >> 32;
+        p += 8;
+        len -= 8;
+    }
+    uint64_t tail = 0;
+    memcpy(&tail, p, len);
+    h = (h ^ tail) * 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 29;
+    h *= 0xFF51AFD7ED558CCDull;
+    return h ^ (h >> 32);
+}
+
+inline uint64_t snapshotRound8(uint64_t n)
+{
+    return (n + 7) & ~(uint64_t)7;
+}
+
+// Codificacion de un campo: tipos trivialmente copiables (valor inline)
+template <typename T, typename = void>
+struct SnapshotCodec
+{
+    static_assert(is_trivially_copyable<T>::value, "snapshot: el tipo debe ser trivialmente copiable o std::string");
+
+    typedef T view_type;
+    typedef const T &key_view;
+    static const uint32_t kind = 0;
+    static const uint32_t size = sizeof(T);
+    static const uint64_t fieldSize = (sizeof(T) + 7) & ~(size_t)7;
+
+    static void write(char *field, const T &v, string &)
+    {
+        memcpy(field, &v, sizeof(T));
+    }
+
+    static view_type read(const char *field, const char *, uint64_t)
+    {
+        T v;
+        memcpy(&v, field, sizeof(T));
+        return v;
+    }
+
+    // Las claves se comparan por bytes: sin padding para que sea valido
+    static uint64_t hash(key_view key)
+    {
+        static_assert(has_unique_object_representations<T>::value, "snapshot: la clave no puede tener padding");
+        return snapshotHashBytes(&key, sizeof(T));
+    }
+
+    static bool equals(const char *field, const char *, uint64_t, key_view key)
+    {
+        return memcmp(field, &key, sizeof(T)) == 0;
+    }
+};
+
+// std::string: (offset, longitud) en el blob; se lee como string_view
+template <>
+struct SnapshotCodec<string>
+{
+    typedef string_view view_type;
+    typedef string_view key_view;
+    static const uint32_t kind = 1;
+    static const uint32_t size = 0;
+    static const uint64_t fieldSize = 16;
+
+    static void write(char *field, const string &v, string &blob)
+    {
+        uint64_t ref[2] = {(uint64_t)blob.size(), (uint64_t)v.size()};
+        memcpy(field, ref, sizeof(ref));
+        blob.append(v);
+    }
+
+    // blobSize acota la referencia: un archivo corrupto no lee fuera del blob
+    static view_type read(const char *field, const char *blob, uint64_t blobSize)
+    {
+        uint64_t ref[2];
+        memcpy(ref, field, sizeof(ref));
+        if (ref[0] > blobSize || ref[1] > blobSize - ref[0])
+            throw runtime_error("snapshot: string out of bounds");
+        return string_view(blob + ref[0], (size_t)ref[1]);
+    }
+
+    static uint64_t hash(key_view key)
+    {
+        return snapshotHashBytes(key.data(), key.size());
+    }
+
+    static bool equals(const char *field, const char *blob, uint64_t blobSize, key_view key)
+    {
+        return read(field, blob, blobSize) == key;
+    }
+};
+
+/*Escribe el snapshot; visit(emit) debe llamar emit(key, value) en orden de insercion*/
+template <typename TK, typename TV, typename Visit>
+void writeSnapshot(const string &path, uint64_t count, Visit visit)
+{
+    typedef SnapshotCodec<TK> KeyCodec;
+    typedef SnapshotCodec<TV> ValueCodec;
+    const uint64_t recordSize = 8 + KeyCodec::fieldSize + ValueCodec::fieldSize;
+
+    uint64_t indexSize = 1;
+    while (indexSize < count * 2) // factor de carga del indice <= 1/2
+        indexSize <<= 1;
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, snapshotMagic, sizeof(header.magic));
+    header.version = snapshotVersion;
+    header.endianTag = snapshotEndianTag;
+    header.keyKind = KeyCodec::kind;
+    header.valueKind = ValueCodec::kind;
+    header.keySize = KeyCodec::size;
+    header.valueSize = ValueCodec::size;
+    header.count = count;
+    header.indexSize = indexSize;
+    header.entriesOffset = snapshotRound8(sizeof(SnapshotHeader));
+    header.indexOffset = header.entriesOffset + count * recordSize;
+
+    ofstream out(path, ios::binary | ios::trunc);
+    if (!out)
+        throw runtime_error("snapshot: cannot open " + path);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write("\0\0\0\0\0\0\0", (streamsize)(header.entriesOffset - sizeof(header)));
+
+    uint64_t *index = new uint64_t[indexSize]();
+    string blob;
+    char *record = new char[recordSize];
+    uint64_t written = 0;
+    try
+    {
+        visit([&](const TK &key, const TV &value)
+              {
+                  if (written == count)
+                      throw logic_error("snapshot: more entries than declared");
+                  memset(record, 0, recordSize);
+                  uint64_t h = KeyCodec::hash(key);
+                  memcpy(record, &h, 8);
+                  KeyCodec::write(record + 8, key, blob);
+                  ValueCodec::write(record + 8 + KeyCodec::fieldSize, value, blob);
+                  out.write(record, (streamsize)recordSize);
+
+                  uint64_t i = h & (indexSize - 1);
+                  while (index[i])
+                      i = (i + 1) & (indexSize - 1);
+                  index[i] = ++written; });
+        if (written != count)
+            throw logic_error("snapshot: fewer entries than declared");
+
+        out.write(reinterpret_cast<const char *>(index), (streamsize)(indexSize * sizeof(uint64_t)));
+        header.blobOffset = header.indexOffset + indexSize * sizeof(uint64_t);
+        header.fileSize = header.blobOffset + blob.size();
+        out.write(blob.data(), (streamsize)blob.size());
+        out.seekp(0);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    }
+    catch (...)
+    {
+        delete[] index;
+        delete[] record;
+        throw;
+    }
+    delete[] index;
+    delete[] record;
+
+    out.flush();
+    if (!out)
+        throw runtime_error("snapshot: write failed for " + path);
+}
+
+#endif
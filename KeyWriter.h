@@ -0,0 +1,194 @@
+#ifndef KEY_WRITER_H
+#define KEY_WRITER_H
+
+#include <string>
+#include <sstream>
+#include <ostream>
+#include <string_view>
+#include <charconv>
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define KEY_WRITER_FD 1
+#elif defined(_WIN32)
+#include <io.h>
+#define KEY_WRITER_FD 1
+#endif
+
+using namespace std;
+
+/*
+ * Escritor de claves por bloques: junta las claves en un buffer de tamano
+ * fijo y lo vacia a un descriptor de archivo, un string o un ostream cuando
+ * se llena, asi volcar un arbol grande usa memoria acotada. Los enteros se
+ * formatean con to_chars directo en el buffer; los string se copian tal cual
+ * y el resto de los tipos pasa por operator<< (misma salida que stringstream).
+ * Cada clave va seguida del separador.
+ */
+class KeyWriter
+{
+private:
+    enum Sink
+    {
+        ToFd,
+        ToString,
+        ToStream
+    };
+
+    // Espacio que reserva to_chars: alcanza para cualquier entero de 64 bits
+    static const size_t MaxDigits = 24;
+
+    Sink sink;
+    int fd;
+    string *str;
+    ostream *os;
+    char *buffer;
+    size_t capacity;
+    size_t used;
+    string separator;
+    ostringstream fallback; // solo para tipos sin to_chars
+
+    template <typename K>
+    static constexpr bool useToChars()
+    {
+        // char y bool se imprimen como caracter / 0-1 con operator<<
+        return is_integral<K>::value && !is_same<K, bool>::value && !is_same<K, char>::value &&
+               !is_same<K, signed char>::value && !is_same<K, unsigned char>::value &&
+               !is_same<K, wchar_t>::value && !is_same<K, char16_t>::value && !is_same<K, char32_t>::value;
+    }
+
+    void drain(const char *data, size_t len)
+    {
+        switch (sink)
+        {
+        case ToFd:
+#ifdef KEY_WRITER_FD
+            while (len > 0)
+            {
+#ifdef _WIN32
+                int w = _write(fd, data, (unsigned)len);
+#else
+                ssize_t w = ::write(fd, data, len);
+#endif
+                if (w < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    throw runtime_error("KeyWriter: write failed");
+                }
+                data += w;
+                len -= (size_t)w;
+            }
+#endif
+            break;
+        case ToString:
+            str->append(data, len);
+            break;
+        case ToStream:
+            if (!os->write(data, (streamsize)len))
+                throw runtime_error("KeyWriter: write failed");
+            break;
+        }
+    }
+
+    void init(size_t cap)
+    {
+        capacity = cap < 2 * MaxDigits ? 2 * MaxDigits : cap;
+        buffer = new char[capacity];
+        used = 0;
+    }
+
+public:
+    static const size_t DefaultCapacity = 1 << 16;
+
+#ifdef KEY_WRITER_FD
+    explicit KeyWriter(int fd, size_t capacity = DefaultCapacity, const string &sep = " ")
+        : sink(ToFd), fd(fd), str(nullptr), os(nullptr), separator(sep)
+    {
+        init(capacity);
+    }
+#endif
+
+    explicit KeyWriter(string &out, size_t capacity = DefaultCapacity, const string &sep = " ")
+        : sink(ToString), fd(-1), str(&out), os(nullptr), separator(sep)
+    {
+        init(capacity);
+    }
+
+    explicit KeyWriter(ostream &out, size_t capacity = DefaultCapacity, const string &sep = " ")
+        : sink(ToStream), fd(-1), str(nullptr), os(&out), separator(sep)
+    {
+        init(capacity);
+    }
+
+    KeyWriter(const KeyWriter &) = delete;
+    KeyWriter &operator=(const KeyWriter &) = delete;
+
+    ~KeyWriter()
+    {
+        try
+        {
+            flush();
+        }
+        catch (...)
+        {
+        }
+        delete[] buffer;
+    }
+
+    // Bytes crudos; lo que no entra en el buffer se vacia directo
+    void write(const char *data, size_t len)
+    {
+        if (used + len > capacity)
+        {
+            flush();
+            if (len > capacity)
+            {
+                drain(data, len);
+                return;
+            }
+        }
+        memcpy(buffer + used, data, len);
+        used += len;
+    }
+
+    template <typename K>
+    void put(const K &key) // Escribe la clave y el separador
+    {
+        if constexpr (useToChars<K>())
+        {
+            if (used + MaxDigits > capacity)
+                flush();
+            used = to_chars(buffer + used, buffer + capacity, key).ptr - buffer;
+        }
+        else if constexpr (is_convertible<const K &, string_view>::value)
+        {
+            string_view s = key;
+            write(s.data(), s.size());
+        }
+        else
+        {
+            fallback.str(string());
+            fallback.clear();
+            fallback << key;
+            string s = fallback.str();
+            write(s.data(), s.size());
+        }
+        write(separator.data(), separator.size());
+    }
+
+    void flush() // Vacia el buffer al destino
+    {
+        if (!used)
+            return;
+        size_t len = used;
+        used = 0;
+        drain(buffer, len);
+    }
+};
+
+#endif
@@ -0,0 +1,263 @@
+#ifndef MAPPED_HASHTABLE_H
+#define MAPPED_HASHTABLE_H
+
+#include <vector>
+#include <utility>
+#include "HashTableSnapshot.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MAPPED_HASHTABLE_MMAP 1
+#endif
+
+/*
+ * Vista de solo lectura de un snapshot escrito con HashTable::save(): el
+ * archivo se mapea con mmap y find/at/recorrido en orden de insercion se
+ * sirven directo desde el mapeo, sin reconstruir nada. Los valores string
+ * se entregan como string_view apuntando al mapeo (validos mientras viva
+ * el MappedHashTable). Sin mmap el archivo se lee completo a memoria.
+ * Al abrir se valida el layout contra el tamaño del archivo; los slots del
+ * indice y las referencias a string se verifican al leerlos, asi un archivo
+ * corrupto lanza runtime_error en vez de leer fuera del mapeo.
+ */
+template <typename TK, typename TV>
+class MappedHashTable
+{
+private:
+    typedef SnapshotCodec<TK> KeyCodec;
+    typedef SnapshotCodec<TV> ValueCodec;
+
+public:
+    typedef typename KeyCodec::key_view key_view;
+    typedef typename KeyCodec::view_type key_type;
+    typedef typename ValueCodec::view_type value_type;
+
+    class iterator
+    {
+    private:
+        const MappedHashTable *table;
+        uint64_t pos;
+
+    public:
+        iterator(const MappedHashTable *t, uint64_t p) : table(t), pos(p) {}
+
+        bool operator!=(const iterator &other) const
+        {
+            return pos != other.pos;
+        }
+
+        iterator &operator++()
+        {
+            ++pos;
+            return *this;
+        }
+
+        pair<key_type, value_type> operator*() const
+        {
+            return {table->keyAt(pos), table->valueAt(pos)};
+        }
+    };
+
+    iterator begin() const { return iterator(this, 0); }               // Retorna el inicio del iterador
+    iterator end() const { return iterator(this, header.count); }      // Retorna el final del iterador
+
+private:
+    const char *data;
+    size_t length;
+    bool mapped;
+    SnapshotHeader header;
+    const char *entries;
+    const uint64_t *index;
+    const char *blob;
+    uint64_t blobSize;
+
+    static const uint64_t recordSize = 8 + KeyCodec::fieldSize + ValueCodec::fieldSize;
+
+    const char *record(uint64_t i) const
+    {
+        return entries + i * recordSize;
+    }
+
+    key_type keyAt(uint64_t i) const
+    {
+        return KeyCodec::read(record(i) + 8, blob, blobSize);
+    }
+
+    value_type valueAt(uint64_t i) const
+    {
+        return ValueCodec::read(record(i) + 8 + KeyCodec::fieldSize, blob, blobSize);
+    }
+
+    // Numero de entrada + 1, o 0 si la clave no esta. Recorre a lo sumo
+    // indexSize slots: un indice corrupto sin slots vacios no cicla para siempre
+    uint64_t lookup(key_view key) const
+    {
+        uint64_t h = KeyCodec::hash(key);
+        uint64_t mask = header.indexSize - 1;
+        uint64_t i = h & mask;
+        for (uint64_t probes = 0; probes < header.indexSize; ++probes, i = (i + 1) & mask)
+        {
+            uint64_t slot = index[i];
+            if (!slot)
+                return 0;
+            if (slot > header.count)
+                throw runtime_error("snapshot: index slot out of bounds");
+            const char *r = record(slot - 1);
+            uint64_t stored;
+            memcpy(&stored, r, 8);
+            if (stored == h && KeyCodec::equals(r + 8, blob, blobSize, key))
+                return slot;
+        }
+        return 0;
+    }
+
+    void load(const string &path)
+    {
+#ifdef MAPPED_HASHTABLE_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw runtime_error("snapshot: cannot open " + path);
+        struct stat st;
+        if (fstat(fd, &st) != 0)
+        {
+            ::close(fd);
+            throw runtime_error("snapshot: cannot stat " + path);
+        }
+        length = (size_t)st.st_size;
+        void *p = length ? mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+        ::close(fd);
+        if (p == MAP_FAILED)
+            throw runtime_error("snapshot: cannot map " + path);
+        data = static_cast<const char *>(p);
+        mapped = true;
+#else
+        ifstream in(path, ios::binary | ios::ate);
+        if (!in)
+            throw runtime_error("snapshot: cannot open " + path);
+        length = (size_t)in.tellg();
+        char *buffer = new char[length];
+        in.seekg(0);
+        in.read(buffer, (streamsize)length);
+        data = buffer;
+        mapped = false;
+        if (!in)
+        {
+            unload();
+            throw runtime_error("snapshot: cannot read " + path);
+        }
+#endif
+    }
+
+    void unload()
+    {
+        if (!data)
+            return;
+#ifdef MAPPED_HASHTABLE_MMAP
+        if (mapped)
+            munmap(const_cast<char *>(data), length);
+        else
+#endif
+            delete[] data;
+        data = nullptr;
+    }
+
+    void validate()
+    {
+        if (length < sizeof(SnapshotHeader))
+            throw runtime_error("snapshot: truncated header");
+        memcpy(&header, data, sizeof(header));
+        if (memcmp(header.magic, snapshotMagic, sizeof(header.magic)) != 0 ||
+            header.version != snapshotVersion || header.endianTag != snapshotEndianTag)
+            throw runtime_error("snapshot: bad magic, version or byte order");
+        if (header.keyKind != KeyCodec::kind || header.keySize != KeyCodec::size ||
+            header.valueKind != ValueCodec::kind || header.valueSize != ValueCodec::size)
+            throw runtime_error("snapshot: key/value types do not match");
+        // Cada seccion se compara con lo que queda del archivo antes de
+        // multiplicar, asi count * recordSize e indexSize * 8 no desbordan
+        uint64_t fileSize = length;
+        if (header.fileSize != fileSize ||
+            header.entriesOffset < sizeof(SnapshotHeader) || header.entriesOffset % 8 || header.entriesOffset > fileSize ||
+            header.count > (fileSize - header.entriesOffset) / recordSize ||
+            header.indexOffset != header.entriesOffset + header.count * recordSize ||
+            header.indexSize == 0 || (header.indexSize & (header.indexSize - 1)) || header.indexSize <= header.count ||
+            header.indexSize > (fileSize - header.indexOffset) / sizeof(uint64_t) ||
+            header.blobOffset != header.indexOffset + header.indexSize * sizeof(uint64_t))
+            throw runtime_error("snapshot: corrupt layout");
+        entries = data + header.entriesOffset;
+        index = reinterpret_cast<const uint64_t *>(data + header.indexOffset);
+        blob = data + header.blobOffset;
+        blobSize = fileSize - header.blobOffset;
+    }
+
+public:
+    explicit MappedHashTable(const string &path) : data(nullptr), length(0), mapped(false), blobSize(0)
+    {
+        load(path);
+        try
+        {
+            validate();
+        }
+        catch (...)
+        {
+            unload();
+            throw;
+        }
+    }
+
+    MappedHashTable(const MappedHashTable &) = delete;
+    MappedHashTable &operator=(const MappedHashTable &) = delete;
+
+    ~MappedHashTable()
+    {
+        unload();
+    }
+
+    bool find(key_view key) const
+    {
+        return lookup(key) != 0;
+    }
+
+    value_type at(key_view key) const
+    {
+        uint64_t slot = lookup(key);
+        if (!slot)
+            throw out_of_range("Key not found");
+        return valueAt(slot - 1);
+    }
+
+    size_t getSize() const
+    {
+        return (size_t)header.count;
+    }
+
+    /*Recorre en orden de insercion sin copiar: f(clave, valor) como vistas*/
+    template <typename F>
+    void forEach(F f) const
+    {
+        for (uint64_t i = 0; i < header.count; ++i)
+            f(keyAt(i), valueAt(i));
+    }
+
+    vector<TK> getAllKeys() const
+    {
+        vector<TK> keys;
+        keys.reserve((size_t)header.count);
+        for (uint64_t i = 0; i < header.count; ++i)
+            keys.emplace_back(keyAt(i));
+        return keys;
+    }
+
+    vector<pair<TK, TV>> getAllElements() const
+    {
+        vector<pair<TK, TV>> elements;
+        elements.reserve((size_t)header.count);
+        for (uint64_t i = 0; i < header.count; ++i)
+            elements.emplace_back(TK(keyAt(i)), TV(valueAt(i)));
+        return elements;
+    }
+};
+
+#endif
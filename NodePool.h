@@ -0,0 +1,209 @@
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+#include <cstddef>
+#include <new>
+#include <memory>
+
+/*
+ * Pool de bloques de tamaño fijo: entrega nodos desde chunks grandes y
+ * reutiliza los liberados con una free list. release() devuelve toda la
+ * memoria en O(chunks), sin recorrer los nodos uno por uno.
+ */
+class NodePool
+{
+private:
+    struct Chunk
+    {
+        Chunk *next;
+    };
+
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    size_t blockSize;      // 0 hasta el primer allocate
+    size_t blocksPerChunk;
+    Chunk *chunks;
+    FreeBlock *freeList;
+    char *bump;            // siguiente bloque nunca entregado del chunk actual
+    char *bumpEnd;
+
+    static const size_t chunkBytes = 64 * 1024;
+
+    static size_t headerSize()
+    {
+        // el encabezado del chunk ocupa un bloque alineado a max_align_t
+        return (sizeof(Chunk) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+    }
+
+    void newChunk()
+    {
+        size_t bytes = headerSize() + blockSize * blocksPerChunk;
+        Chunk *c = static_cast<Chunk *>(::operator new(bytes));
+        c->next = chunks;
+        chunks = c;
+        bump = reinterpret_cast<char *>(c) + headerSize();
+        bumpEnd = bump + blockSize * blocksPerChunk;
+    }
+
+public:
+    NodePool() : blockSize(0), blocksPerChunk(0), chunks(nullptr), freeList(nullptr), bump(nullptr), bumpEnd(nullptr) {}
+
+    NodePool(const NodePool &) = delete;
+    NodePool &operator=(const NodePool &) = delete;
+
+    ~NodePool()
+    {
+        release();
+    }
+
+    static size_t roundBlock(size_t size)
+    {
+        size_t a = alignof(std::max_align_t);
+        if (size < sizeof(FreeBlock))
+            size = sizeof(FreeBlock);
+        return (size + a - 1) / a * a;
+    }
+
+    /*El primer tipo que se pide fija el tamaño de bloque del pool*/
+    bool serves(size_t size, size_t align)
+    {
+        if (align > alignof(std::max_align_t))
+            return false;
+        if (blockSize == 0)
+        {
+            blockSize = roundBlock(size);
+            blocksPerChunk = chunkBytes / blockSize;
+            if (blocksPerChunk < 16)
+                blocksPerChunk = 16;
+            return true;
+        }
+        return roundBlock(size) == blockSize;
+    }
+
+    void *allocate()
+    {
+        if (freeList)
+        {
+            FreeBlock *b = freeList;
+            freeList = b->next;
+            return b;
+        }
+        if (bump == bumpEnd)
+            newChunk();
+        void *p = bump;
+        bump += blockSize;
+        return p;
+    }
+
+    void deallocate(void *p)
+    {
+        FreeBlock *b = static_cast<FreeBlock *>(p);
+        b->next = freeList;
+        freeList = b;
+    }
+
+    /*Libera todos los chunks; los bloques entregados quedan invalidos*/
+    void release()
+    {
+        while (chunks)
+        {
+            Chunk *next = chunks->next;
+            ::operator delete(chunks);
+            chunks = next;
+        }
+        freeList = nullptr;
+        bump = bumpEnd = nullptr;
+    }
+};
+
+/*
+ * Allocator que usa un NodePool. Las copias y los rebinds comparten el mismo
+ * pool, por lo que un contenedor puede liberar con cualquiera de ellas.
+ * Las peticiones de otro tamaño o de n > 1 van a ::operator new.
+ */
+template <typename T>
+class PoolAllocator
+{
+    template <typename U>
+    friend class PoolAllocator;
+
+private:
+    std::shared_ptr<NodePool> pool;
+
+public:
+    typedef T value_type;
+
+    PoolAllocator() : pool(std::make_shared<NodePool>()) {}
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U> &other) : pool(other.pool) {}
+
+    T *allocate(size_t n)
+    {
+        if (n == 1 && pool->serves(sizeof(T), alignof(T)))
+            return static_cast<T *>(pool->allocate());
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T *p, size_t n)
+    {
+        if (n == 1 && pool->serves(sizeof(T), alignof(T)))
+            pool->deallocate(p);
+        else
+            ::operator delete(p);
+    }
+
+    /*Si ningun otro allocator comparte el pool, libera todos sus chunks*/
+    bool releaseIfExclusive()
+    {
+        if (pool.use_count() != 1)
+            return false;
+        pool->release();
+        return true;
+    }
+
+    bool exclusive() const
+    {
+        return pool.use_count() == 1;
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U> &other) const
+    {
+        return pool == other.pool;
+    }
+
+    template <typename U>
+    bool operator!=(const PoolAllocator<U> &other) const
+    {
+        return pool != other.pool;
+    }
+};
+
+// Los contenedores preguntan si pueden soltar todos sus nodos de una vez:
+// solo un PoolAllocator no compartido lo permite
+template <typename A>
+bool poolExclusive(const A &)
+{
+    return false;
+}
+
+template <typename T>
+bool poolExclusive(const PoolAllocator<T> &a)
+{
+    return a.exclusive();
+}
+
+template <typename A>
+void poolRelease(A &) {}
+
+template <typename T>
+void poolRelease(PoolAllocator<T> &a)
+{
+    a.releaseIfExclusive();
+}
+
+#endif
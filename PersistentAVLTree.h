@@ -0,0 +1,389 @@
+#ifndef PERSISTENT_AVLTREE_H
+#define PERSISTENT_AVLTREE_H
+
+#include <atomic>
+#include <utility>
+#include <type_traits>
+#include <algorithm>
+#include "AVL_Node.h"
+#include "AVL_Iterator.h"
+
+using namespace std;
+
+/*
+ * AVLTree persistente: snapshot() es O(1) y devuelve una vista inmutable del
+ * arbol en ese momento. Los nodos se comparten entre versiones con un contador
+ * de referencias; insert/remove copian solo los nodos compartidos del camino
+ * que modifican (y el hermano que toca una rotacion), los nodos exclusivos se
+ * modifican en el lugar. Los Snapshot se pueden recorrer y soltar desde otros
+ * hilos; el arbol y snapshot() son de un solo hilo escritor.
+ */
+template <typename T>
+class PersistentAVLTree
+{
+private:
+    // Deriva de NodeAVL para que AVLIterator recorra los snapshots
+    struct PNode : NodeAVL<T>
+    {
+        atomic<size_t> refs; // enlaces y raices que apuntan al nodo
+
+        // Reenvia la clave a NodeAVL (se mueve si llega como rvalue); excluye
+        // PNode para que copiar un nodo no pase por aqui
+        template <typename K, typename = typename enable_if<!is_same<typename decay<K>::type, PNode>::value>::type>
+        explicit PNode(K &&value) : NodeAVL<T>(std::forward<K>(value)), refs(1) {}
+
+        explicit PNode(const PNode &other) : NodeAVL<T>(other), refs(1) {}
+    };
+
+    static const int MaxPath = AVLIterator<T>::MaxDepth;
+
+    NodeAVL<T> *root;
+
+    static void retain(NodeAVL<T> *node)
+    {
+        if (node)
+            static_cast<PNode *>(node)->refs.fetch_add(1, memory_order_relaxed);
+    }
+
+    // Suelta una referencia; el ultimo libera el nodo y suelta sus hijos
+    static void release(NodeAVL<T> *node)
+    {
+        while (node && static_cast<PNode *>(node)->refs.fetch_sub(1, memory_order_acq_rel) == 1)
+        {
+            release(node->left);
+            NodeAVL<T> *right = node->right;
+            delete static_cast<PNode *>(node);
+            node = right;
+        }
+    }
+
+    static bool shared(NodeAVL<T> *node)
+    {
+        return static_cast<PNode *>(node)->refs.load(memory_order_acquire) > 1;
+    }
+
+    /*Antes de modificar un nodo: si esta compartido se reemplaza en su
+      enlace por una copia (que comparte los hijos)*/
+    static void own(NodeAVL<T> *&link)
+    {
+        if (!shared(link))
+            return;
+        NodeAVL<T> *copy = new PNode(*static_cast<PNode *>(link));
+        retain(copy->left);
+        retain(copy->right);
+        NodeAVL<T> *old = link;
+        link = copy;
+        release(old);
+    }
+
+    static int height(NodeAVL<T> *node)
+    {
+        return node ? node->height : -1;
+    }
+
+    static size_t count(NodeAVL<T> *node)
+    {
+        return node ? node->count : 0;
+    }
+
+    static void updateHeight(NodeAVL<T> *node)
+    {
+        node->height = 1 + std::max(height(node->left), height(node->right));
+        node->count = 1 + count(node->left) + count(node->right);
+    }
+
+    static int balancingFactor(NodeAVL<T> *node)
+    {
+        return height(node->left) - height(node->right);
+    }
+
+    // node ya es propio; el hijo que sube se copia si esta compartido
+    static void right_rota(NodeAVL<T> *&node)
+    {
+        own(node->left);
+        NodeAVL<T> *newRoot = node->left;
+        node->left = newRoot->right;
+        newRoot->right = node;
+        updateHeight(node);
+        updateHeight(newRoot);
+        node = newRoot;
+    }
+
+    static void left_rota(NodeAVL<T> *&node)
+    {
+        own(node->right);
+        NodeAVL<T> *newRoot = node->right;
+        node->right = newRoot->left;
+        newRoot->left = node;
+        updateHeight(node);
+        updateHeight(newRoot);
+        node = newRoot;
+    }
+
+    static void balance(NodeAVL<T> *&node)
+    {
+        updateHeight(node);
+        int bf = balancingFactor(node);
+        if (bf > 1)
+        {
+            if (balancingFactor(node->left) < 0)
+            {
+                own(node->left);
+                left_rota(node->left);
+            }
+            right_rota(node);
+        }
+        else if (bf < -1)
+        {
+            if (balancingFactor(node->right) > 0)
+            {
+                own(node->right);
+                right_rota(node->right);
+            }
+            left_rota(node);
+        }
+    }
+
+    // Como AVLTree::retrace: los nodos del camino ya son propios
+    static void retrace(NodeAVL<T> **path[], int n, int delta)
+    {
+        while (n > 0)
+        {
+            NodeAVL<T> **link = path[--n];
+            int oldHeight = (*link)->height;
+            balance(*link);
+            if ((*link)->height == oldHeight)
+            {
+                while (n > 0)
+                    (*path[--n])->count += delta;
+                return;
+            }
+        }
+    }
+
+    static bool contains(NodeAVL<T> *node, const T &value)
+    {
+        while (node)
+        {
+            if (value < node->data)
+                node = node->left;
+            else if (node->data < value)
+                node = node->right;
+            else
+                return true;
+        }
+        return false;
+    }
+
+    template <typename K>
+    void insertKey(K &&value)
+    {
+        // Con versiones vivas se evita copiar el camino de una clave repetida
+        if (root && shared(root) && contains(root, value))
+            return;
+        NodeAVL<T> **path[MaxPath];
+        int n = 0;
+        NodeAVL<T> **link = &root;
+        while (*link)
+        {
+            own(*link);
+            path[n++] = link;
+            if (value < (*link)->data)
+                link = &(*link)->left;
+            else if ((*link)->data < value)
+                link = &(*link)->right;
+            else
+                return;
+        }
+        *link = new PNode(std::forward<K>(value));
+        retrace(path, n, 1);
+    }
+
+public:
+    typedef AVLIterator<T> iterator;
+
+    /*Vista inmutable de una version; copiarla es O(1)*/
+    class Snapshot
+    {
+    private:
+        NodeAVL<T> *root;
+
+        friend class PersistentAVLTree;
+
+        explicit Snapshot(NodeAVL<T> *r) : root(r)
+        {
+            retain(root);
+        }
+
+    public:
+        Snapshot() : root(nullptr) {}
+
+        Snapshot(const Snapshot &other) : root(other.root)
+        {
+            retain(root);
+        }
+
+        Snapshot(Snapshot &&other) : root(other.root)
+        {
+            other.root = nullptr;
+        }
+
+        Snapshot &operator=(Snapshot other)
+        {
+            std::swap(root, other.root);
+            return *this;
+        }
+
+        ~Snapshot()
+        {
+            release(root);
+        }
+
+        iterator begin(AVLIterator<int>::Type _) const
+        {
+            return iterator(root, (typename iterator::Type)_);
+        } // Retorna el inicio del iterador
+
+        iterator end() const
+        {
+            return iterator(nullptr, iterator::InOrder);
+        } // Retorna el final del iterador
+
+        bool find(const T &value) const // O(log n)
+        {
+            return contains(root, value);
+        }
+
+        int size() const // O(1)
+        {
+            return (int)count(root);
+        }
+    };
+
+    PersistentAVLTree() : root(nullptr) {}
+
+    PersistentAVLTree(const PersistentAVLTree &other) : root(other.root) // O(1): comparte los nodos
+    {
+        retain(root);
+    }
+
+    PersistentAVLTree(PersistentAVLTree &&other) : root(other.root)
+    {
+        other.root = nullptr;
+    }
+
+    PersistentAVLTree &operator=(PersistentAVLTree other)
+    {
+        std::swap(root, other.root);
+        return *this;
+    }
+
+    ~PersistentAVLTree()
+    {
+        release(root);
+    }
+
+    Snapshot snapshot() const // O(1)
+    {
+        return Snapshot(root);
+    }
+
+    iterator begin(AVLIterator<int>::Type _)
+    {
+        return iterator(root, (typename iterator::Type)_);
+    } // Retorna el inicio del iterador
+
+    iterator end()
+    {
+        return iterator(nullptr, iterator::InOrder);
+    } // Retorna el final del iterador
+
+    void insert(const T &value) // O(log n)
+    {
+        insertKey(value);
+    }
+
+    void insert(T &&value) // O(log n)
+    {
+        insertKey(std::move(value));
+    }
+
+    void remove(const T &value) // Use el predecesor para cuando el nodo a eliminar tiene dos hijos
+    {
+        if (!root || (shared(root) && !contains(root, value)))
+            return;
+        NodeAVL<T> **path[MaxPath];
+        int n = 0;
+        NodeAVL<T> **link = &root;
+        while (*link)
+        {
+            own(*link);
+            if (value < (*link)->data)
+            {
+                path[n++] = link;
+                link = &(*link)->left;
+            }
+            else if ((*link)->data < value)
+            {
+                path[n++] = link;
+                link = &(*link)->right;
+            }
+            else
+            {
+                break;
+            }
+        }
+        NodeAVL<T> *node = *link;
+        if (!node)
+            return;
+
+        if (node->left && node->right)
+        {
+            path[n++] = link;
+            int below = n;
+            NodeAVL<T> **predLink = &node->left;
+            own(*predLink);
+            while ((*predLink)->right)
+            {
+                path[n++] = predLink;
+                predLink = &(*predLink)->right;
+                own(*predLink);
+            }
+            NodeAVL<T> *pred = *predLink;
+            *predLink = pred->left;
+            pred->left = node->left;
+            pred->right = node->right;
+            pred->height = node->height;
+            pred->count = node->count;
+            *link = pred;
+            if (below < n)
+                path[below] = &pred->left;
+        }
+        else
+        {
+            // La referencia del nodo a su hijo pasa al enlace
+            *link = node->left ? node->left : node->right;
+        }
+        node->left = node->right = nullptr;
+        release(node);
+        retrace(path, n, -1);
+    }
+
+    bool find(const T &value) // O(log n)
+    {
+        return contains(root, value);
+    }
+
+    int size() // O(1)
+    {
+        return (int)count(root);
+    }
+
+    void clear()
+    {
+        release(root);
+        root = nullptr;
+    }
+};
+
+#endif
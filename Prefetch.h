@@ -0,0 +1,15 @@
+#ifndef PREFETCH_H
+#define PREFETCH_H
+
+// Prefetch de una linea de cache para lectura; no hace nada si el
+// compilador no tiene un intrinseco conocido
+#if defined(__GNUC__) || defined(__clang__)
+#define DICT_PREFETCH(addr) __builtin_prefetch((const void *)(addr))
+#elif defined(_MSC_VER)
+#include <xmmintrin.h>
+#define DICT_PREFETCH(addr) _mm_prefetch((const char *)(addr), _MM_HINT_T0)
+#else
+#define DICT_PREFETCH(addr) ((void)(addr))
+#endif
+
+#endif
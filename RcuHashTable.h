@@ -0,0 +1,333 @@
+#ifndef RCU_HASHTABLE_H
+#define RCU_HASHTABLE_H
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <stdexcept>
+#include "EpochReclaim.h"
+
+using namespace std;
+
+/*
+ * HashTable para cargas de casi solo lectura: find/get/at y el recorrido en
+ * orden de insercion no toman locks. Los escritores se serializan con un
+ * mutex y publican con atomics:
+ *  - un nodo nunca cambia key/value; actualizar un valor reemplaza el nodo
+ *  - los nodos desenlazados y las tablas viejas se liberan por epocas (EBR)
+ *  - rehashing() no toca las cadenas publicadas: copia los nodos a una tabla
+ *    nueva (buckets y lista en orden de insercion) y la publica con un solo
+ *    store; un lector termina sobre la tabla que cargo, que sigue intacta
+ * Asi una busqueda recorre una sola cadena y nunca reintenta.
+ * Cada lectura abre un EpochGuard (una barrera de memoria); en bucles
+ * calientes conviene abrir un EpochGuard afuera: los anidados son gratis.
+ */
+template <typename TK, typename TV>
+class RcuHashTable
+{
+public:
+    typedef typename conditional<is_same<TK, string>::value, string_view, const TK &>::type key_view;
+
+private:
+    struct Node
+    {
+        const size_t hashCode;
+        const TK key;
+        const TV value;
+        atomic<Node *> nextBucket;
+        atomic<Node *> nextOrdered;
+        Node *prevOrdered; // solo lo usa el escritor
+
+        template <typename K, typename V>
+        Node(size_t h, K &&k, V &&v)
+            : hashCode(h), key(std::forward<K>(k)), value(std::forward<V>(v)),
+              nextBucket(nullptr), nextOrdered(nullptr), prevOrdered(nullptr) {}
+    };
+
+    // Buckets y lista en orden de insercion: la tabla es duena de sus nodos
+    struct Table
+    {
+        size_t capacity; // potencia de 2
+        atomic<Node *> *buckets;
+        atomic<Node *> headOrdered;
+
+        explicit Table(size_t cap) : capacity(cap), buckets(new atomic<Node *>[cap]), headOrdered(nullptr)
+        {
+            for (size_t i = 0; i < capacity; ++i)
+                buckets[i].store(nullptr, memory_order_relaxed);
+        }
+
+        /*Libera los nodos que siguen enlazados; los eliminados se retiran aparte*/
+        ~Table()
+        {
+            Node *current = headOrdered.load(memory_order_relaxed);
+            while (current)
+            {
+                Node *next = current->nextOrdered.load(memory_order_relaxed);
+                delete current;
+                current = next;
+            }
+            delete[] buckets;
+        }
+    };
+
+    atomic<Table *> table;
+    Node *tailOrdered; // solo lo usa el escritor
+    atomic<size_t> size;
+    float maxLoad;
+    mutex writeLock;
+    RetireList retired;
+
+    static size_t hashKey(key_view key)
+    {
+        size_t h = std::hash<typename decay<key_view>::type>()(key);
+        h ^= h >> 32;
+        h *= (size_t)0x9E3779B97F4A7C15ull;
+        return h ^ (h >> 29);
+    }
+
+    static void deleteNode(void *p)
+    {
+        delete static_cast<Node *>(p);
+    }
+
+    static void deleteTable(void *p)
+    {
+        delete static_cast<Table *>(p);
+    }
+
+    /*Busqueda sin locks; requiere un EpochGuard activo*/
+    Node *lookup(key_view key)
+    {
+        size_t h = hashKey(key);
+        Table *t = table.load(memory_order_acquire);
+        Node *current = t->buckets[h & (t->capacity - 1)].load(memory_order_acquire);
+        while (current)
+        {
+            if (current->hashCode == h && current->key == key)
+                return current;
+            current = current->nextBucket.load(memory_order_acquire);
+        }
+        return nullptr;
+    }
+
+    /*Enlace al nodo con key dentro de su cadena (solo escritor)*/
+    atomic<Node *> *findLink(Table *t, key_view key, size_t h)
+    {
+        atomic<Node *> *link = &t->buckets[h & (t->capacity - 1)];
+        for (Node *current = link->load(memory_order_relaxed); current; current = link->load(memory_order_relaxed))
+        {
+            if (current->hashCode == h && current->key == key)
+                return link;
+            link = &current->nextBucket;
+        }
+        return nullptr;
+    }
+
+    void linkOrdered(Table *t, Node *node, Node *prev, Node *next)
+    {
+        node->prevOrdered = prev;
+        node->nextOrdered.store(next, memory_order_relaxed);
+        if (next)
+            next->prevOrdered = node;
+        else
+            tailOrdered = node;
+        if (prev)
+            prev->nextOrdered.store(node, memory_order_release);
+        else
+            t->headOrdered.store(node, memory_order_release);
+    }
+
+    void unlinkOrdered(Table *t, Node *node)
+    {
+        Node *next = node->nextOrdered.load(memory_order_relaxed);
+        if (next)
+            next->prevOrdered = node->prevOrdered;
+        else
+            tailOrdered = node->prevOrdered;
+        if (node->prevOrdered)
+            node->prevOrdered->nextOrdered.store(next, memory_order_release);
+        else
+            t->headOrdered.store(next, memory_order_release);
+    }
+
+    /*Copia los nodos a una tabla nueva sin tocar la publicada: los lectores
+      que ya cargaron la vieja la recorren completa hasta que se libera*/
+    void rehashing(size_t newCapacity)
+    {
+        Table *old = table.load(memory_order_relaxed);
+        Table *t = new Table(newCapacity);
+
+        Node *last = nullptr;
+        try
+        {
+            for (Node *current = old->headOrdered.load(memory_order_relaxed); current;
+                 current = current->nextOrdered.load(memory_order_relaxed))
+            {
+                Node *node = new Node(current->hashCode, current->key, current->value);
+                atomic<Node *> &bucket = t->buckets[node->hashCode & (newCapacity - 1)];
+                node->nextBucket.store(bucket.load(memory_order_relaxed), memory_order_relaxed);
+                bucket.store(node, memory_order_relaxed);
+
+                node->prevOrdered = last;
+                if (last)
+                    last->nextOrdered.store(node, memory_order_relaxed);
+                else
+                    t->headOrdered.store(node, memory_order_relaxed);
+                last = node;
+            }
+        }
+        catch (...)
+        {
+            delete t; // libera las copias; la tabla publicada no cambio
+            throw;
+        }
+        tailOrdered = last;
+
+        // Un solo store publica buckets y lista; los nodos viejos se van con old
+        table.store(t, memory_order_release);
+        retired.retire(old, &deleteTable);
+    }
+
+    template <typename F>
+    void forEachNode(F f)
+    {
+        EpochGuard guard;
+        Table *t = table.load(memory_order_acquire);
+        for (Node *current = t->headOrdered.load(memory_order_acquire); current;
+             current = current->nextOrdered.load(memory_order_acquire))
+            f(current);
+    }
+
+public:
+    RcuHashTable(size_t _cap = 8) : tailOrdered(nullptr), size(0), maxLoad(1.0f)
+    {
+        size_t cap = 1;
+        while (cap < _cap)
+            cap <<= 1;
+        table.store(new Table(cap), memory_order_relaxed);
+    }
+
+    RcuHashTable(const RcuHashTable &) = delete;
+    RcuHashTable &operator=(const RcuHashTable &) = delete;
+
+    /*No debe haber lectores activos al destruir la tabla*/
+    ~RcuHashTable()
+    {
+        retired.drain();
+        delete table.load(memory_order_relaxed);
+    }
+
+    /*Inserta o sobrescribe (el nodo se reemplaza en su misma posicion)*/
+    template <typename K, typename V>
+    void insert(K &&key, V &&value)
+    {
+        lock_guard<mutex> lock(writeLock);
+        size_t h = hashKey(key);
+        Table *t = table.load(memory_order_relaxed);
+        atomic<Node *> *link = findLink(t, key, h);
+        if (link)
+        {
+            Node *old = link->load(memory_order_relaxed);
+            Node *node = new Node(h, old->key, std::forward<V>(value));
+            node->nextBucket.store(old->nextBucket.load(memory_order_relaxed), memory_order_relaxed);
+            linkOrdered(t, node, old->prevOrdered, old->nextOrdered.load(memory_order_relaxed));
+            link->store(node, memory_order_release);
+            retired.retire(old, &deleteNode);
+            return;
+        }
+
+        if ((double)(size.load(memory_order_relaxed) + 1) > (double)t->capacity * maxLoad)
+        {
+            rehashing(t->capacity * 2);
+            t = table.load(memory_order_relaxed);
+        }
+
+        Node *node = new Node(h, std::forward<K>(key), std::forward<V>(value));
+        atomic<Node *> &bucket = t->buckets[h & (t->capacity - 1)];
+        node->nextBucket.store(bucket.load(memory_order_relaxed), memory_order_relaxed);
+        linkOrdered(t, node, tailOrdered, nullptr);
+        bucket.store(node, memory_order_release);
+        size.fetch_add(1, memory_order_relaxed);
+    }
+
+    void insert(const pair<TK, TV> &item)
+    {
+        insert(item.first, item.second);
+    }
+
+    bool remove(key_view key)
+    {
+        lock_guard<mutex> lock(writeLock);
+        size_t h = hashKey(key);
+        Table *t = table.load(memory_order_relaxed);
+        atomic<Node *> *link = findLink(t, key, h);
+        if (!link)
+            return false;
+        Node *node = link->load(memory_order_relaxed);
+        link->store(node->nextBucket.load(memory_order_relaxed), memory_order_release);
+        unlinkOrdered(t, node);
+        size.fetch_sub(1, memory_order_relaxed);
+        retired.retire(node, &deleteNode);
+        return true;
+    }
+
+    bool find(key_view key)
+    {
+        EpochGuard guard;
+        return lookup(key) != nullptr;
+    }
+
+    bool get(key_view key, TV &out)
+    {
+        EpochGuard guard;
+        Node *node = lookup(key);
+        if (!node)
+            return false;
+        out = node->value;
+        return true;
+    }
+
+    TV at(key_view key)
+    {
+        EpochGuard guard;
+        Node *node = lookup(key);
+        if (!node)
+            throw out_of_range("Key not found");
+        return node->value;
+    }
+
+    size_t getSize()
+    {
+        return size.load(memory_order_relaxed);
+    }
+
+    /*Recorre sin locks en orden de insercion; puede no ver cambios concurrentes*/
+    template <typename F>
+    void forEach(F f)
+    {
+        forEachNode([&](Node *n)
+                    { f(n->key, n->value); });
+    }
+
+    vector<TK> getAllKeys()
+    {
+        vector<TK> keys;
+        forEachNode([&](Node *n)
+                    { keys.push_back(n->key); });
+        return keys;
+    }
+
+    vector<pair<TK, TV>> getAllElements()
+    {
+        vector<pair<TK, TV>> elements;
+        forEachNode([&](Node *n)
+                    { elements.emplace_back(n->key, n->value); });
+        return elements;
+    }
+};
+
+#endif
@@ -0,0 +1,1371 @@
+/*
+ * Benchmark de HashTable y AVLTree contra std::unordered_map y std::set.
+ *
+ * Operaciones: insert, find_hit, find_miss, iterate (en orden para los
+ * arboles, orden de insercion para HashTable), remove y mixed (90% find,
+ * 5% insert, 5% remove). Claves int64 y string con distribuciones:
+ *   uniform    claves al azar, consultas uniformes
+ *   zipf       claves al azar, consultas Zipf (theta = 0.99)
+ *   sequential claves 0..n-1 insertadas y consultadas en orden
+ *   colliding  int: i << 24 (bits bajos iguales); string: prefijo comun de
+ *              64 caracteres (hash y comparaciones recorren todo el prefijo)
+ *
+ * La matriz incluye tambien CompactHashTable, ConcurrentHashTable,
+ * RcuHashTable y AVLTree(parallel) (iterate con parallel_reduce en todos
+ * los nucleos). MappedHashTable y FrozenAVL son de solo lectura: se arman
+ * desde un HashTable/AVLTree lleno y en lugar de insert miden esa copia
+ * (operaciones save_load y freeze); no tienen remove ni mixed, y FrozenAVL
+ * tampoco iterate.
+ *
+ * Resultado en CSV o JSON (ns por operacion, mediana de --reps corridas):
+ *   bench --sizes=1000,1000000 --format=json --out=result.json
+ * Ver bench --help para los filtros.
+ *
+ * Ademas de la matriz anterior (suite "containers") hay suites para las
+ * variantes, elegidas con --suites (o --suites=all):
+ *   concurrent_hash  mixed (90% get, 5% insert, 5% remove) repartido entre
+ *                    1..N hilos: ConcurrentHashTable contra un HashTable con
+ *                    un solo mutex. ns_per_op es tiempo de pared / operaciones
+ *   concurrent_avl   la misma carga sobre ConcurrentAVLTree (lectores sin
+ *                    locks) contra un AVLTree con un solo mutex
+ *   insert_latency   cada insert medido por separado: p50, p99, p99.9 y
+ *                    maximo para HashTable con rehashing de una vez o
+ *                    incremental, y unordered_map; el histograma (log2 de
+ *                    los ns) de la ultima repeticion sale por stderr. Cada
+ *                    muestra incluye ~20 ns de leer el reloj
+ *   batch_lookup     HashTable::find en un ciclo contra find_many por lotes
+ *                    (aciertos y fallos). Sin --sizes usa una tabla de 1/4
+ *                    de la LLC y otra de 4 veces la LLC
+ *   bulk_insert      carga de n claves: AVLTree con insert uno a uno contra
+ *                    assign_sorted, mezcla de n/2 claves en un arbol de n/2
+ *                    con insert contra insert_bulk, y HashTable con insert
+ *                    contra insert_many. Ordenar las claves no se mide
+ *   iteration        AVLTree recorrido completo en los cuatro ordenes del
+ *                    iterador, en orden copiando el iterador en cada paso,
+ *                    y set en orden. Sin --sizes usa 10M claves
+ *   frozen_lookup    find (aciertos y fallos) en AVLTree contra su freeze().
+ *                    Sin --sizes usa arboles de 1/2 L2, 1/2 LLC y 4 veces
+ *                    la LLC
+ *   parallel         AVLTree: parallel_reduce (checksum de los hashes),
+ *                    parallel_for_each_indexed (llena un arreglo en orden)
+ *                    e isBalanced en cada valor de --threads, mas el mismo
+ *                    checksum con for_each_inorder como referencia. Sin
+ *                    --sizes usa 10M claves
+ * Los tamanos que dependen de la cache salen de sysconf (si no esta:
+ * L2 = 1 MB, LLC = 32 MB) y del tamano aproximado de un nodo.
+ * Las suites con hilos corren para cada valor de --threads (por defecto
+ * 1, 2, 4, ... hasta los nucleos de la maquina).
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+#include "AVL.h"
+#include "HashTable.h"
+#include "CompactHashTable.h"
+#include "ConcurrentHashTable.h"
+#include "RcuHashTable.h"
+#include "MappedHashTable.h"
+#include "ConcurrentAVLTree.h"
+#include "FrozenAVL.h"
+
+using namespace std;
+
+static volatile size_t sink; // evita que el compilador descarte los resultados
+
+/*Claves*/
+
+static uint64_t splitmix64(uint64_t x) // biyectiva: ids distintos dan claves distintas
+{
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+enum Dist
+{
+    Uniform,
+    Zipf,
+    Sequential,
+    Colliding
+};
+
+static const char *distNames[] = {"uniform", "zipf", "sequential", "colliding"};
+
+template <typename K>
+struct KeyMaker;
+
+template <>
+struct KeyMaker<int64_t>
+{
+    static const char *name() { return "int64"; }
+
+    static int64_t make(uint64_t id, Dist dist)
+    {
+        switch (dist)
+        {
+        case Sequential:
+            return (int64_t)id;
+        case Colliding:
+            return (int64_t)(id << 24);
+        default:
+            return (int64_t)splitmix64(id);
+        }
+    }
+};
+
+template <>
+struct KeyMaker<string>
+{
+    static const char *name() { return "string"; }
+
+    static string make(uint64_t id, Dist dist)
+    {
+        char buf[96];
+        switch (dist)
+        {
+        case Sequential:
+            snprintf(buf, sizeof(buf), "%012llu", (unsigned long long)id);
+            break;
+        case Colliding:
+            snprintf(buf, sizeof(buf), "%s%llu",
+                     "collide/collide/collide/collide/collide/collide/collide/collide/",
+                     (unsigned long long)id);
+            break;
+        default:
+            snprintf(buf, sizeof(buf), "%016llx", (unsigned long long)splitmix64(id));
+            break;
+        }
+        return buf;
+    }
+};
+
+/*Generador Zipf de Gray et al. ("Quickly generating billion-record
+  synthetic databases"): O(n) para preparar zeta(n), O(1) por muestra*/
+class ZipfGenerator
+{
+private:
+    size_t n;
+    double theta, alpha, zetan, eta;
+
+public:
+    ZipfGenerator(size_t _n, double _theta) : n(_n), theta(_theta)
+    {
+        zetan = 0;
+        for (size_t i = 1; i <= n; ++i)
+            zetan += 1.0 / pow((double)i, theta);
+        double zeta2 = 1.0 + 1.0 / pow(2.0, theta);
+        alpha = 1.0 / (1.0 - theta);
+        eta = (1.0 - pow(2.0 / (double)n, 1.0 - theta)) / (1.0 - zeta2 / zetan);
+    }
+
+    template <typename Rng>
+    size_t operator()(Rng &rng) // rango en [0, n), 0 es el mas frecuente
+    {
+        double u = uniform_real_distribution<double>(0.0, 1.0)(rng);
+        double uz = u * zetan;
+        if (uz < 1.0)
+            return 0;
+        if (uz < 1.0 + pow(0.5, theta))
+            return n > 1 ? 1 : 0;
+        size_t r = (size_t)((double)n * pow(eta * u - eta + 1.0, alpha));
+        return r < n ? r : n - 1;
+    }
+};
+
+// Con pocas claves se repiten consultas para que el tiempo sea medible
+static size_t queryCount(size_t n)
+{
+    return std::min<size_t>(std::max<size_t>(n, 1 << 17), 1 << 22);
+}
+
+// q consultas que estan, con la distribucion de dist
+template <typename K>
+static vector<K> hitQueries(const vector<K> &keys, size_t q, Dist dist, mt19937_64 &rng)
+{
+    const size_t n = keys.size();
+    vector<K> hits;
+    hits.reserve(q);
+    if (dist == Zipf)
+    {
+        ZipfGenerator zipf(n, 0.99);
+        for (size_t i = 0; i < q; ++i)
+            hits.push_back(keys[zipf(rng)]);
+    }
+    else if (dist == Sequential)
+    {
+        for (size_t i = 0; i < q; ++i)
+            hits.push_back(keys[i % n]);
+    }
+    else
+    {
+        for (size_t i = 0; i < q; ++i)
+            hits.push_back(keys[rng() % n]);
+    }
+    return hits;
+}
+
+template <typename K>
+struct Workload
+{
+    vector<K> keys;     // n claves distintas en orden de insercion
+    vector<K> hits;     // consultas que estan
+    vector<K> misses;   // consultas que no estan
+    vector<K> removals; // las n claves en orden aleatorio
+    vector<uint8_t> mixedOps; // 0 find, 1 insert, 2 remove
+    vector<K> mixedKeys;
+
+    Workload(size_t n, Dist dist, uint64_t seed)
+    {
+        mt19937_64 rng(seed);
+        size_t q = queryCount(n);
+
+        keys.reserve(n);
+        for (size_t i = 0; i < n; ++i)
+            keys.push_back(KeyMaker<K>::make(i, dist));
+
+        hits = hitQueries(keys, q, dist, rng);
+
+        // ids >= n nunca estan en el contenedor
+        misses.reserve(q);
+        for (size_t i = 0; i < q; ++i)
+            misses.push_back(KeyMaker<K>::make(n + i, dist));
+
+        removals = keys;
+        shuffle(removals.begin(), removals.end(), rng);
+
+        mixedOps.reserve(q);
+        mixedKeys.reserve(q);
+        size_t fresh = n + q;
+        for (size_t i = 0; i < q; ++i)
+        {
+            unsigned r = (unsigned)(rng() % 100);
+            if (r < 90)
+            {
+                mixedOps.push_back(0);
+                mixedKeys.push_back(hits[i]);
+            }
+            else if (r < 95)
+            {
+                mixedOps.push_back(1);
+                mixedKeys.push_back(KeyMaker<K>::make(fresh++, dist));
+            }
+            else
+            {
+                mixedOps.push_back(2);
+                mixedKeys.push_back(hits[i]);
+            }
+        }
+    }
+};
+
+/*Adaptadores: la misma interfaz para los cuatro contenedores*/
+
+template <typename K>
+struct HashTableAdapter
+{
+    static const char *name() { return "HashTable"; }
+    HashTable<K, int> table;
+    void insert(const K &key) { table.insert(key, 1); }
+    bool find(const K &key) { return table.find(key); }
+    void remove(const K &key) { table.remove(key); }
+    size_t iterate()
+    {
+        size_t total = 0;
+        for (auto it = table.begin(); it != table.end(); ++it)
+            total += (size_t)(*it).second;
+        return total;
+    }
+};
+
+template <typename K>
+struct UnorderedMapAdapter
+{
+    static const char *name() { return "unordered_map"; }
+    unordered_map<K, int> table;
+    void insert(const K &key) { table.emplace(key, 1); }
+    bool find(const K &key) { return table.find(key) != table.end(); }
+    void remove(const K &key) { table.erase(key); }
+    size_t iterate()
+    {
+        size_t total = 0;
+        for (auto &item : table)
+            total += (size_t)item.second;
+        return total;
+    }
+};
+
+template <typename K>
+struct AVLTreeAdapter
+{
+    static const char *name() { return "AVLTree"; }
+    AVLTree<K> tree;
+    void insert(const K &key) { tree.insert(key); }
+    bool find(const K &key) { return tree.find(key); }
+    void remove(const K &key) { tree.remove(key); }
+    size_t iterate()
+    {
+        size_t total = 0;
+        for (auto it = tree.begin(AVLIterator<int>::InOrder); it != tree.end(); ++it)
+            total++;
+        return total;
+    }
+};
+
+template <typename K>
+struct SetAdapter
+{
+    static const char *name() { return "set"; }
+    set<K> tree;
+    void insert(const K &key) { tree.insert(key); }
+    bool find(const K &key) { return tree.find(key) != tree.end(); }
+    void remove(const K &key) { tree.erase(key); }
+    size_t iterate()
+    {
+        size_t total = 0;
+        for (auto it = tree.begin(); it != tree.end(); ++it)
+            total++;
+        return total;
+    }
+};
+
+template <typename K>
+struct CompactHashAdapter
+{
+    static const char *name() { return "CompactHashTable"; }
+    CompactHashTable<K, int> table;
+    void insert(const K &key) { table.insert(key, 1); }
+    bool find(const K &key) { return table.find(key); }
+    void remove(const K &key) { table.remove(key); }
+    size_t iterate()
+    {
+        size_t total = 0;
+        for (auto it = table.begin(); it != table.end(); ++it)
+            total += (size_t)(*it).second;
+        return total;
+    }
+};
+
+template <typename K>
+struct RcuHashAdapter
+{
+    static const char *name() { return "RcuHashTable"; }
+    RcuHashTable<K, int> table;
+    void insert(const K &key) { table.insert(key, 1); }
+    bool find(const K &key) { return table.find(key); }
+    void remove(const K &key) { table.remove(key); }
+    size_t iterate()
+    {
+        size_t total = 0;
+        table.forEach([&](const K &, int value) { total += (size_t)value; });
+        return total;
+    }
+};
+
+// iterate con los recorridos paralelos; el resto es el AVLTree de siempre
+template <typename K>
+struct ParallelAVLAdapter : AVLTreeAdapter<K>
+{
+    static const char *name() { return "AVLTree(parallel)"; }
+    size_t iterate()
+    {
+        return this->tree.parallel_reduce(
+            (size_t)0, [](const K &) { return (size_t)1; }, [](size_t a, size_t b) { return a + b; });
+    }
+};
+
+/*Adaptadores de solo lectura: fill arma el contenedor de origen (sin medir)
+  y build la copia que se consulta*/
+
+static const string mappedPath = "bench_mapped.snap";
+
+template <typename K>
+struct MappedHashAdapter
+{
+    static const char *name() { return "MappedHashTable"; }
+    static const char *buildOp() { return "save_load"; }
+    static const bool iterable = true;
+    typedef HashTable<K, int> Source;
+    unique_ptr<MappedHashTable<K, int>> table;
+    static void fill(Source &source, const K &key) { source.insert(key, 1); }
+    void build(Source &source)
+    {
+        source.save(mappedPath);
+        table.reset(new MappedHashTable<K, int>(mappedPath));
+    }
+    bool find(const K &key) { return table->find(key); }
+    size_t iterate()
+    {
+        size_t total = 0;
+        table->forEach([&](typename MappedHashTable<K, int>::key_type, int value) { total += (size_t)value; });
+        return total;
+    }
+};
+
+template <typename K>
+struct FrozenAdapter
+{
+    static const char *name() { return "FrozenAVL"; }
+    static const char *buildOp() { return "freeze"; }
+    static const bool iterable = false;
+    typedef AVLTree<K> Source;
+    unique_ptr<FrozenAVL<K>> frozen;
+    static void fill(Source &source, const K &key) { source.insert(key); }
+    void build(Source &source) { frozen.reset(new FrozenAVL<K>(source.freeze())); }
+    bool find(const K &key) { return frozen->find(key); }
+    size_t iterate() { return 0; }
+};
+
+// HashTable con rehashing incremental (suite insert_latency)
+template <typename K>
+struct IncrementalHashAdapter : HashTableAdapter<K>
+{
+    static const char *name() { return "HashTable(incremental)"; }
+    IncrementalHashAdapter() { this->table.incremental_rehash(true); }
+};
+
+/*Adaptadores para varios hilos (suite concurrent_hash)*/
+
+template <typename K>
+struct ConcurrentHashAdapter
+{
+    static const char *name() { return "ConcurrentHashTable"; }
+    ConcurrentHashTable<K, int> table;
+    void insert(const K &key) { table.insert(key, 1); }
+    bool find(const K &key)
+    {
+        int value;
+        return table.get(key, value);
+    }
+    void remove(const K &key) { table.remove(key); }
+    size_t iterate()
+    {
+        size_t total = 0;
+        table.forEach([&](const K &, int value) { total += (size_t)value; });
+        return total;
+    }
+};
+
+// Linea base: el HashTable de siempre detras de un solo mutex
+template <typename K>
+struct LockedHashAdapter
+{
+    static const char *name() { return "HashTable+mutex"; }
+    mutex lock;
+    HashTable<K, int> table;
+    void insert(const K &key)
+    {
+        lock_guard<mutex> guard(lock);
+        table.insert(key, 1);
+    }
+    bool find(const K &key)
+    {
+        lock_guard<mutex> guard(lock);
+        return table.find(key);
+    }
+    void remove(const K &key)
+    {
+        lock_guard<mutex> guard(lock);
+        table.remove(key);
+    }
+};
+
+template <typename K>
+struct ConcurrentAVLAdapter
+{
+    static const char *name() { return "ConcurrentAVLTree"; }
+    ConcurrentAVLTree<K> tree;
+    void insert(const K &key) { tree.insert(key); }
+    bool find(const K &key) { return tree.find(key); }
+    void remove(const K &key) { tree.remove(key); }
+};
+
+template <typename K>
+struct LockedAVLAdapter
+{
+    static const char *name() { return "AVLTree+mutex"; }
+    mutex lock;
+    AVLTree<K> tree;
+    void insert(const K &key)
+    {
+        lock_guard<mutex> guard(lock);
+        tree.insert(key);
+    }
+    bool find(const K &key)
+    {
+        lock_guard<mutex> guard(lock);
+        return tree.find(key);
+    }
+    void remove(const K &key)
+    {
+        lock_guard<mutex> guard(lock);
+        tree.remove(key);
+    }
+};
+
+/*Opciones y salida*/
+
+enum Op
+{
+    OpInsert,
+    OpFindHit,
+    OpFindMiss,
+    OpIterate,
+    OpRemove,
+    OpMixed,
+    OpCount
+};
+
+static const char *opNames[] = {"insert", "find_hit", "find_miss", "iterate", "remove", "mixed"};
+
+struct Options
+{
+    vector<size_t> sizes{1000, 10000, 100000, 1000000};
+    bool sizesGiven = false; // con --sizes las suites no eligen sus tamanos
+    vector<string> keys{"int64", "string"};
+    vector<string> dists{"uniform", "zipf", "sequential", "colliding"};
+    vector<string> containers{"HashTable", "unordered_map", "AVLTree", "set", "CompactHashTable",
+                              "ConcurrentHashTable", "RcuHashTable", "AVLTree(parallel)", "MappedHashTable",
+                              "FrozenAVL"};
+    vector<string> ops{"insert", "find_hit", "find_miss", "iterate", "remove", "mixed"};
+    vector<string> suites{"containers"};
+    vector<unsigned> threads;
+    int reps = 3;
+    uint64_t seed = 42;
+    string format = "csv";
+    string out;
+
+    static bool has(const vector<string> &list, const string &name)
+    {
+        return find(list.begin(), list.end(), name) != list.end();
+    }
+};
+
+static const char *suiteNames[] = {"containers", "concurrent_hash", "concurrent_avl", "insert_latency",
+                                   "batch_lookup", "bulk_insert", "iteration", "frozen_lookup", "parallel"};
+
+struct Result
+{
+    string container, key, dist, op;
+    size_t size, ops;
+    double nsPerOp;
+    unsigned threads = 1;
+};
+
+static void addResult(vector<Result> &results, const string &container, const string &key, const string &dist,
+                      const string &op, size_t size, size_t ops, double nsPerOp, unsigned threads = 1)
+{
+    Result r;
+    r.container = container;
+    r.key = key;
+    r.dist = dist;
+    r.op = op;
+    r.size = size;
+    r.ops = ops;
+    r.nsPerOp = nsPerOp;
+    r.threads = threads;
+    results.push_back(r);
+    cerr << r.container << ' ' << r.key << ' ' << r.dist << ' ' << r.size << ' ' << r.op;
+    if (threads > 1)
+        cerr << " x" << threads;
+    cerr << ": " << r.nsPerOp << " ns/op" << endl;
+}
+
+// 1, 2, 4, ... y la cantidad de nucleos
+static vector<unsigned> defaultThreads()
+{
+    unsigned cores = std::max(1u, thread::hardware_concurrency());
+    vector<unsigned> counts;
+    for (unsigned t = 1; t < cores; t *= 2)
+        counts.push_back(t);
+    counts.push_back(cores);
+    return counts;
+}
+
+// Bytes de la cache de nivel 2 o de la LLC
+static size_t cacheBytes(int level)
+{
+    long bytes = 0;
+#if defined(_SC_LEVEL2_CACHE_SIZE) && defined(_SC_LEVEL3_CACHE_SIZE)
+    bytes = sysconf(level == 2 ? _SC_LEVEL2_CACHE_SIZE : _SC_LEVEL3_CACHE_SIZE);
+#endif
+    if (bytes <= 0)
+        bytes = level == 2 ? 1L << 20 : 32L << 20;
+    return (size_t)bytes;
+}
+
+// Claves que ocupan bytes, con nodeBytes por clave
+static size_t keysFor(double bytes, size_t nodeBytes)
+{
+    return std::max<size_t>(1, (size_t)(bytes / (double)nodeBytes));
+}
+
+static vector<size_t> suiteSizes(const Options &opt, const vector<size_t> &defaults)
+{
+    return opt.sizesGiven ? opt.sizes : defaults;
+}
+
+static vector<string> splitList(const string &s)
+{
+    vector<string> parts;
+    stringstream ss(s);
+    string part;
+    while (getline(ss, part, ','))
+        if (!part.empty())
+            parts.push_back(part);
+    return parts;
+}
+
+static void usage()
+{
+    cerr << "uso: bench [--sizes=1000,10000,...] [--keys=int64,string]\n"
+            "             [--dists=uniform,zipf,sequential,colliding]\n"
+            "             [--containers=HashTable,unordered_map,AVLTree,set,CompactHashTable,\n"
+            "                           ConcurrentHashTable,RcuHashTable,AVLTree(parallel),\n"
+            "                           MappedHashTable,FrozenAVL]\n"
+            "             [--ops=insert,find_hit,find_miss,iterate,remove,mixed]\n"
+            "             [--suites=containers,concurrent_hash,concurrent_avl,insert_latency,\n"
+            "                       batch_lookup,bulk_insert,iteration,frozen_lookup,parallel|all]\n"
+            "             [--threads=1,2,4,...]\n"
+            "             [--reps=3] [--seed=42] [--format=csv|json] [--out=archivo]\n"
+            "tamanos hasta 100000000; con 100M claves string se necesitan decenas de GB\n";
+}
+
+static bool parseOptions(int argc, char **argv, Options &opt)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        size_t eq = arg.find('=');
+        string name = arg.substr(0, eq);
+        string value = eq == string::npos ? string() : arg.substr(eq + 1);
+        try
+        {
+            if (name == "--sizes")
+            {
+                opt.sizes.clear();
+                opt.sizesGiven = true;
+                for (const string &s : splitList(value))
+                    opt.sizes.push_back((size_t)stod(s)); // acepta 1e6
+            }
+            else if (name == "--keys")
+                opt.keys = splitList(value);
+            else if (name == "--dists")
+                opt.dists = splitList(value);
+            else if (name == "--containers")
+                opt.containers = splitList(value);
+            else if (name == "--ops")
+                opt.ops = splitList(value);
+            else if (name == "--suites")
+                opt.suites = value == "all" ? vector<string>(begin(suiteNames), end(suiteNames)) : splitList(value);
+            else if (name == "--threads")
+            {
+                opt.threads.clear();
+                for (const string &t : splitList(value))
+                    opt.threads.push_back((unsigned)std::max(1, stoi(t)));
+            }
+            else if (name == "--reps")
+                opt.reps = std::max(1, stoi(value));
+            else if (name == "--seed")
+                opt.seed = stoull(value);
+            else if (name == "--format" && (value == "csv" || value == "json"))
+                opt.format = value;
+            else if (name == "--out")
+                opt.out = value;
+            else
+                return false;
+        }
+        catch (const exception &)
+        {
+            return false;
+        }
+    }
+    for (size_t n : opt.sizes)
+        if (n == 0)
+            return false;
+    for (const string &suite : opt.suites)
+        if (!Options::has(vector<string>(begin(suiteNames), end(suiteNames)), suite))
+            return false;
+    if (opt.threads.empty())
+        opt.threads = defaultThreads();
+    return true;
+}
+
+static void writeResults(ostream &out, const Options &opt, const vector<Result> &results)
+{
+    if (opt.format == "csv")
+    {
+        out << "container,key_type,distribution,size,operation,ops,ns_per_op,threads\n";
+        for (const Result &r : results)
+            out << r.container << ',' << r.key << ',' << r.dist << ',' << r.size << ','
+                << r.op << ',' << r.ops << ',' << r.nsPerOp << ',' << r.threads << '\n';
+        return;
+    }
+    out << "{\n  \"reps\": " << opt.reps << ",\n  \"seed\": " << opt.seed << ",\n";
+#ifdef __VERSION__
+    out << "  \"compiler\": \"" << __VERSION__ << "\",\n";
+#endif
+    out << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const Result &r = results[i];
+        out << "    {\"container\": \"" << r.container << "\", \"key_type\": \"" << r.key
+            << "\", \"distribution\": \"" << r.dist << "\", \"size\": " << r.size
+            << ", \"operation\": \"" << r.op << "\", \"ops\": " << r.ops
+            << ", \"ns_per_op\": " << r.nsPerOp << ", \"threads\": " << r.threads
+            << '}' << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+}
+
+/*Medicion*/
+
+template <typename F>
+static double elapsedNs(F f)
+{
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+}
+
+// Mediana de las muestras (las reordena)
+static double median(vector<double> &s)
+{
+    nth_element(s.begin(), s.begin() + s.size() / 2, s.end());
+    return s[s.size() / 2];
+}
+
+/*Corre task(i) en threads hilos a la vez: el tiempo se mide desde que todos
+  estan listos hasta que termina el ultimo*/
+template <typename F>
+static double elapsedThreadsNs(unsigned threads, F task)
+{
+    atomic<unsigned> ready(0);
+    atomic<bool> go(false);
+    vector<thread> pool;
+    for (unsigned i = 0; i < threads; ++i)
+        pool.emplace_back([&, i] {
+            ready.fetch_add(1);
+            while (!go.load(memory_order_acquire))
+                this_thread::yield();
+            task(i);
+        });
+    while (ready.load() != threads)
+        this_thread::yield();
+    auto start = chrono::steady_clock::now();
+    go.store(true, memory_order_release);
+    for (thread &t : pool)
+        t.join();
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+}
+
+template <typename Adapter, typename K>
+static void runContainer(const Options &opt, const Workload<K> &w, Dist dist, vector<Result> &results)
+{
+    const size_t n = w.keys.size();
+    const size_t q = w.hits.size();
+    const size_t opsPer[OpCount] = {n, q, q, n, n, q};
+    vector<double> samples[OpCount];
+
+    bool wanted[OpCount];
+    for (int op = 0; op < OpCount; ++op)
+        wanted[op] = Options::has(opt.ops, opNames[op]);
+
+    for (int rep = 0; rep < opt.reps; ++rep)
+    {
+        // Cada repeticion arranca de un contenedor vacio
+        {
+            Adapter c;
+            samples[OpInsert].push_back(elapsedNs([&] {
+                for (const K &key : w.keys)
+                    c.insert(key);
+            }));
+            if (wanted[OpFindHit])
+                samples[OpFindHit].push_back(elapsedNs([&] {
+                    size_t found = 0;
+                    for (const K &key : w.hits)
+                        found += c.find(key);
+                    sink += found;
+                }));
+            if (wanted[OpFindMiss])
+                samples[OpFindMiss].push_back(elapsedNs([&] {
+                    size_t found = 0;
+                    for (const K &key : w.misses)
+                        found += c.find(key);
+                    sink += found;
+                }));
+            if (wanted[OpIterate])
+                samples[OpIterate].push_back(elapsedNs([&] { sink += c.iterate(); }));
+            if (wanted[OpRemove])
+                samples[OpRemove].push_back(elapsedNs([&] {
+                    for (const K &key : w.removals)
+                        c.remove(key);
+                }));
+        }
+        if (wanted[OpMixed])
+        {
+            Adapter c;
+            for (const K &key : w.keys)
+                c.insert(key);
+            samples[OpMixed].push_back(elapsedNs([&] {
+                size_t found = 0;
+                for (size_t i = 0; i < q; ++i)
+                {
+                    switch (w.mixedOps[i])
+                    {
+                    case 0:
+                        found += c.find(w.mixedKeys[i]);
+                        break;
+                    case 1:
+                        c.insert(w.mixedKeys[i]);
+                        break;
+                    default:
+                        c.remove(w.mixedKeys[i]);
+                        break;
+                    }
+                }
+                sink += found;
+            }));
+        }
+    }
+
+    for (int op = 0; op < OpCount; ++op)
+    {
+        if (!wanted[op] || samples[op].empty())
+            continue;
+        addResult(results, Adapter::name(), KeyMaker<K>::name(), distNames[dist], opNames[op], n, opsPer[op],
+                  median(samples[op]) / (double)opsPer[op]);
+    }
+}
+
+/*Contenedores de solo lectura: build, find_hit, find_miss e iterate*/
+template <typename Adapter, typename K>
+static void runReadOnly(const Options &opt, const Workload<K> &w, Dist dist, vector<Result> &results)
+{
+    const size_t n = w.keys.size();
+    const size_t q = w.hits.size();
+    const int cases = 4;
+    const char *names[cases] = {Adapter::buildOp(), "find_hit", "find_miss", "iterate"};
+    const size_t opsPer[cases] = {n, q, q, n};
+    bool wanted[cases] = {Options::has(opt.ops, "insert"), Options::has(opt.ops, "find_hit"),
+                          Options::has(opt.ops, "find_miss"), Adapter::iterable && Options::has(opt.ops, "iterate")};
+    vector<double> samples[cases];
+
+    for (int rep = 0; rep < opt.reps; ++rep)
+    {
+        typename Adapter::Source source;
+        for (const K &key : w.keys)
+            Adapter::fill(source, key);
+        Adapter c;
+        samples[0].push_back(elapsedNs([&] { c.build(source); }));
+        for (int s = 1; s < 3; ++s)
+        {
+            const vector<K> &queries = s == 1 ? w.hits : w.misses;
+            if (wanted[s])
+                samples[s].push_back(elapsedNs([&] {
+                    size_t found = 0;
+                    for (const K &key : queries)
+                        found += c.find(key);
+                    sink += found;
+                }));
+        }
+        if (wanted[3])
+            samples[3].push_back(elapsedNs([&] { sink += c.iterate(); }));
+    }
+    remove(mappedPath.c_str());
+
+    for (int op = 0; op < cases; ++op)
+        if (wanted[op])
+            addResult(results, Adapter::name(), KeyMaker<K>::name(), distNames[dist], names[op], n, opsPer[op],
+                      median(samples[op]) / (double)opsPer[op]);
+}
+
+/*La carga mixed repartida en bloques contiguos entre los hilos*/
+template <typename Adapter, typename K>
+static void runConcurrent(const Options &opt, const Workload<K> &w, Dist dist, vector<Result> &results)
+{
+    const size_t q = w.mixedOps.size();
+    for (unsigned threads : opt.threads)
+    {
+        vector<double> samples;
+        for (int rep = 0; rep < opt.reps; ++rep)
+        {
+            Adapter c;
+            for (const K &key : w.keys)
+                c.insert(key);
+            atomic<size_t> found(0);
+            samples.push_back(elapsedThreadsNs(threads, [&](unsigned t) {
+                size_t local = 0;
+                for (size_t i = q * t / threads; i < q * (t + 1) / threads; ++i)
+                {
+                    switch (w.mixedOps[i])
+                    {
+                    case 0:
+                        local += c.find(w.mixedKeys[i]);
+                        break;
+                    case 1:
+                        c.insert(w.mixedKeys[i]);
+                        break;
+                    default:
+                        c.remove(w.mixedKeys[i]);
+                        break;
+                    }
+                }
+                found += local;
+            }));
+            sink += found.load();
+        }
+        addResult(results, Adapter::name(), KeyMaker<K>::name(), distNames[dist], "mixed", w.keys.size(), q,
+                  median(samples) / (double)q, threads);
+    }
+}
+
+/*Latencia de cada insert desde un contenedor vacio: el peor caso muestra
+  lo que cuesta el rehashing que cae en un solo insert*/
+template <typename Adapter, typename K>
+static void runLatency(const Options &opt, const Workload<K> &w, Dist dist, vector<Result> &results)
+{
+    static const double quantiles[] = {0.5, 0.99, 0.999, 1.0};
+    static const char *names[] = {"insert_p50", "insert_p99", "insert_p999", "insert_max"};
+    const size_t n = w.keys.size();
+    vector<double> samples[4];
+    vector<double> latency(n);
+    vector<size_t> histogram(64, 0); // [k] = inserts que tardaron [2^(k-1), 2^k) ns
+
+    for (int rep = 0; rep < opt.reps; ++rep)
+    {
+        Adapter c;
+        for (size_t i = 0; i < n; ++i)
+        {
+            auto start = chrono::steady_clock::now();
+            c.insert(w.keys[i]);
+            latency[i] = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        }
+        if (rep + 1 == opt.reps)
+        {
+            fill(histogram.begin(), histogram.end(), 0);
+            for (double ns : latency)
+            {
+                size_t k = 0;
+                while (k < 63 && (double)((uint64_t)1 << k) <= ns)
+                    k++;
+                histogram[k]++;
+            }
+        }
+        sort(latency.begin(), latency.end());
+        for (int q = 0; q < 4; ++q)
+            samples[q].push_back(latency[(size_t)(quantiles[q] * (double)(n - 1))]);
+    }
+
+    for (int q = 0; q < 4; ++q)
+        addResult(results, Adapter::name(), KeyMaker<K>::name(), distNames[dist], names[q], n, n, median(samples[q]));
+    for (size_t k = 0; k < histogram.size(); ++k)
+        if (histogram[k])
+            cerr << "  < " << ((uint64_t)1 << k) << " ns: " << histogram[k] << endl;
+}
+
+/*find en un ciclo contra find_many por lotes sobre la misma tabla: fuera de
+  la cache find_many solapa los fallos de varias busquedas*/
+template <typename K>
+static void runBatchLookup(const Options &opt, const Workload<K> &w, Dist dist, vector<Result> &results)
+{
+    static const char *names[] = {"find_hit_loop", "find_hit_many", "find_miss_loop", "find_miss_many"};
+    const size_t chunk = 1024;
+    const size_t q = w.hits.size();
+    vector<int *> out(chunk);
+    vector<double> samples[4];
+
+    HashTable<K, int> table;
+    for (const K &key : w.keys)
+        table.insert(key, 1);
+
+    for (int rep = 0; rep < opt.reps; ++rep)
+    {
+        for (int s = 0; s < 2; ++s)
+        {
+            const vector<K> &queries = s == 0 ? w.hits : w.misses;
+            samples[2 * s].push_back(elapsedNs([&] {
+                size_t found = 0;
+                for (const K &key : queries)
+                    found += table.find(key);
+                sink += found;
+            }));
+            samples[2 * s + 1].push_back(elapsedNs([&] {
+                size_t found = 0;
+                for (size_t i = 0; i < q; i += chunk)
+                    found += table.find_many(queries.data() + i, std::min(chunk, q - i), out.data());
+                sink += found;
+            }));
+        }
+    }
+
+    for (int i = 0; i < 4; ++i)
+        addResult(results, "HashTable", KeyMaker<K>::name(), distNames[dist], names[i], w.keys.size(), q,
+                  median(samples[i]) / (double)q);
+}
+
+/*Cargas en bloque contra el insert de siempre, con las mismas claves*/
+template <typename K>
+static void runBulkInsert(const Options &opt, const Workload<K> &w, Dist dist, vector<Result> &results)
+{
+    enum
+    {
+        TreeLoop,
+        TreeSorted,
+        MergeLoop,
+        MergeBulk,
+        HashLoop,
+        HashMany,
+        Cases
+    };
+    static const char *containers[] = {"AVLTree", "AVLTree", "AVLTree", "AVLTree", "HashTable", "HashTable"};
+    static const char *names[] = {"build_insert", "build_assign_sorted", "merge_insert", "merge_insert_bulk",
+                                  "build_insert", "build_insert_many"};
+    const size_t n = w.keys.size();
+
+    vector<K> sorted = w.keys;
+    sort(sorted.begin(), sorted.end());
+    vector<K> evens, odds; // el arbol de partida y el lote que se mezcla
+    for (size_t i = 0; i < n; ++i)
+        (i % 2 ? odds : evens).push_back(sorted[i]);
+    vector<pair<K, int>> pairs;
+    pairs.reserve(n);
+    for (const K &key : w.keys)
+        pairs.emplace_back(key, 1);
+
+    vector<double> samples[Cases];
+    for (int rep = 0; rep < opt.reps; ++rep)
+    {
+        {
+            AVLTree<K> tree;
+            samples[TreeLoop].push_back(elapsedNs([&] {
+                for (const K &key : w.keys)
+                    tree.insert(key);
+            }));
+        }
+        {
+            AVLTree<K> tree;
+            samples[TreeSorted].push_back(elapsedNs([&] { tree.assign_sorted(sorted.begin(), sorted.end()); }));
+        }
+        {
+            AVLTree<K> tree(evens.begin(), evens.end());
+            samples[MergeLoop].push_back(elapsedNs([&] {
+                for (const K &key : odds)
+                    tree.insert(key);
+            }));
+        }
+        {
+            AVLTree<K> tree(evens.begin(), evens.end());
+            samples[MergeBulk].push_back(elapsedNs([&] { tree.insert_bulk(odds.begin(), odds.end()); }));
+        }
+        {
+            HashTable<K, int> table;
+            samples[HashLoop].push_back(elapsedNs([&] {
+                for (const K &key : w.keys)
+                    table.insert(key, 1);
+            }));
+        }
+        {
+            HashTable<K, int> table;
+            samples[HashMany].push_back(elapsedNs([&] { table.insert_many(pairs.begin(), pairs.end()); }));
+        }
+    }
+
+    for (int c = 0; c < Cases; ++c)
+    {
+        size_t ops = c == MergeLoop || c == MergeBulk ? std::max<size_t>(odds.size(), 1) : n;
+        addResult(results, containers[c], KeyMaker<K>::name(), distNames[dist], names[c], n, ops,
+                  median(samples[c]) / (double)ops);
+    }
+}
+
+/*Recorridos completos con el iterador; las claves se generan sin Workload y
+  hay un solo contenedor vivo a la vez para que 10M claves quepan en memoria.
+  Los dos arboles se arman desde las claves ordenadas (nodos contiguos)*/
+template <typename K>
+static void runIteration(const Options &opt, size_t n, Dist dist, vector<Result> &results)
+{
+    typedef AVLIterator<int> It;
+    static const It::Type orders[] = {It::PreOrder, It::InOrder, It::PostOrder, It::BFS};
+    static const char *names[] = {"iterate_preorder", "iterate_inorder", "iterate_postorder", "iterate_bfs",
+                                  "iterate_inorder_copy"};
+    vector<double> samples[5], setSamples;
+    vector<K> keys;
+    keys.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+        keys.push_back(KeyMaker<K>::make(i, dist));
+    sort(keys.begin(), keys.end());
+    {
+        AVLTree<K> tree(keys.begin(), keys.end());
+
+        for (int rep = 0; rep < opt.reps; ++rep)
+        {
+            for (int o = 0; o < 4; ++o)
+                samples[o].push_back(elapsedNs([&] {
+                    size_t total = 0;
+                    for (auto it = tree.begin(orders[o]); it != tree.end(); ++it)
+                        total++;
+                    sink += total;
+                }));
+            samples[4].push_back(elapsedNs([&] {
+                size_t total = 0;
+                for (auto it = tree.begin(It::InOrder); it != tree.end(); ++it)
+                {
+                    auto copy = it;
+                    total += copy != tree.end();
+                }
+                sink += total;
+            }));
+        }
+    }
+    {
+        set<K> tree(keys.begin(), keys.end());
+        keys = vector<K>();
+        for (int rep = 0; rep < opt.reps; ++rep)
+            setSamples.push_back(elapsedNs([&] {
+                size_t total = 0;
+                for (auto it = tree.begin(); it != tree.end(); ++it)
+                    total++;
+                sink += total;
+            }));
+    }
+
+    for (int o = 0; o < 5; ++o)
+        addResult(results, "AVLTree", KeyMaker<K>::name(), distNames[dist], names[o], n, n,
+                  median(samples[o]) / (double)n);
+    addResult(results, "set", KeyMaker<K>::name(), distNames[dist], "iterate_inorder", n, n,
+              median(setSamples) / (double)n);
+}
+
+/*AVLTree::find contra FrozenAVL::find con las mismas consultas. Sin Workload:
+  con el tamano de la DRAM las copias de las claves no caben en memoria*/
+template <typename K>
+static void runFrozenLookup(const Options &opt, size_t n, Dist dist, vector<Result> &results)
+{
+    static const char *names[] = {"find_hit", "find_miss"};
+    mt19937_64 rng(opt.seed);
+    const size_t q = queryCount(n);
+
+    vector<K> keys;
+    keys.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+        keys.push_back(KeyMaker<K>::make(i, dist));
+    vector<K> queries[2];
+    queries[0] = hitQueries(keys, q, dist, rng);
+    queries[1].reserve(q);
+    for (size_t i = 0; i < q; ++i)
+        queries[1].push_back(KeyMaker<K>::make(n + i, dist));
+
+    // Insertado en el orden de las claves, como un arbol que crecio con el uso
+    AVLTree<K> tree;
+    for (const K &key : keys)
+        tree.insert(key);
+    keys = vector<K>();
+    FrozenAVL<K> frozen = tree.freeze();
+
+    vector<double> samples[2][2]; // [contenedor][hit/miss]
+    for (int rep = 0; rep < opt.reps; ++rep)
+    {
+        for (int s = 0; s < 2; ++s)
+        {
+            samples[0][s].push_back(elapsedNs([&] {
+                size_t found = 0;
+                for (const K &key : queries[s])
+                    found += tree.find(key);
+                sink += found;
+            }));
+            samples[1][s].push_back(elapsedNs([&] {
+                size_t found = 0;
+                for (const K &key : queries[s])
+                    found += frozen.find(key);
+                sink += found;
+            }));
+        }
+    }
+
+    for (int s = 0; s < 2; ++s)
+    {
+        addResult(results, "AVLTree", KeyMaker<K>::name(), distNames[dist], names[s], n, q,
+                  median(samples[0][s]) / (double)q);
+        addResult(results, "FrozenAVL", KeyMaker<K>::name(), distNames[dist], names[s], n, q,
+                  median(samples[1][s]) / (double)q);
+    }
+}
+
+/*Escalado de los recorridos paralelos de AVLTree de 1 a N hilos*/
+template <typename K>
+static void runParallel(const Options &opt, size_t n, Dist dist, vector<Result> &results)
+{
+    const string key = KeyMaker<K>::name();
+    AVLTree<K> tree;
+    {
+        vector<K> keys;
+        keys.reserve(n);
+        for (size_t i = 0; i < n; ++i)
+            keys.push_back(KeyMaker<K>::make(i, dist));
+        sort(keys.begin(), keys.end());
+        tree.assign_sorted(keys.begin(), keys.end());
+    }
+    hash<K> hasher;
+    vector<size_t> out(n);
+
+    vector<double> serial;
+    for (int rep = 0; rep < opt.reps; ++rep)
+        serial.push_back(elapsedNs([&] {
+            size_t total = 0;
+            tree.for_each_inorder([&](const K &k) { total += hasher(k); });
+            sink += total;
+        }));
+    addResult(results, "AVLTree", key, distNames[dist], "reduce_serial", n, n, median(serial) / (double)n);
+
+    for (unsigned threads : opt.threads)
+    {
+        vector<double> samples[3];
+        for (int rep = 0; rep < opt.reps; ++rep)
+        {
+            samples[0].push_back(elapsedNs([&] {
+                sink += tree.parallel_reduce(
+                    (size_t)0, [&](const K &k) { return hasher(k); }, [](size_t a, size_t b) { return a + b; },
+                    threads);
+            }));
+            samples[1].push_back(elapsedNs([&] {
+                tree.parallel_for_each_indexed([&](size_t i, const K &k) { out[i] = hasher(k); }, threads);
+            }));
+            samples[2].push_back(elapsedNs([&] { sink += tree.isBalanced(threads); }));
+        }
+        addResult(results, "AVLTree", key, distNames[dist], "reduce", n, n, median(samples[0]) / (double)n, threads);
+        addResult(results, "AVLTree", key, distNames[dist], "for_each_indexed", n, n,
+                  median(samples[1]) / (double)n, threads);
+        addResult(results, "AVLTree", key, distNames[dist], "is_balanced", n, n, median(samples[2]) / (double)n,
+                  threads);
+    }
+    sink += out[n / 2];
+}
+
+template <typename K>
+static void runKeyType(const Options &opt, vector<Result> &results)
+{
+    if (!Options::has(opt.keys, KeyMaker<K>::name()))
+        return;
+    for (size_t n : opt.sizes)
+    {
+        for (int d = 0; d < 4; ++d)
+        {
+            if (!Options::has(opt.dists, distNames[d]))
+                continue;
+            Workload<K> w(n, (Dist)d, opt.seed);
+            if (Options::has(opt.suites, "containers"))
+            {
+                if (Options::has(opt.containers, "HashTable"))
+                    runContainer<HashTableAdapter<K>>(opt, w, (Dist)d, results);
+                if (Options::has(opt.containers, "unordered_map"))
+                    runContainer<UnorderedMapAdapter<K>>(opt, w, (Dist)d, results);
+                if (Options::has(opt.containers, "AVLTree"))
+                    runContainer<AVLTreeAdapter<K>>(opt, w, (Dist)d, results);
+                if (Options::has(opt.containers, "set"))
+                    runContainer<SetAdapter<K>>(opt, w, (Dist)d, results);
+                if (Options::has(opt.containers, "CompactHashTable"))
+                    runContainer<CompactHashAdapter<K>>(opt, w, (Dist)d, results);
+                if (Options::has(opt.containers, "ConcurrentHashTable"))
+                    runContainer<ConcurrentHashAdapter<K>>(opt, w, (Dist)d, results);
+                if (Options::has(opt.containers, "RcuHashTable"))
+                    runContainer<RcuHashAdapter<K>>(opt, w, (Dist)d, results);
+                if (Options::has(opt.containers, "AVLTree(parallel)"))
+                    runContainer<ParallelAVLAdapter<K>>(opt, w, (Dist)d, results);
+                if (Options::has(opt.containers, "MappedHashTable"))
+                    runReadOnly<MappedHashAdapter<K>>(opt, w, (Dist)d, results);
+                if (Options::has(opt.containers, "FrozenAVL"))
+                    runReadOnly<FrozenAdapter<K>>(opt, w, (Dist)d, results);
+            }
+            if (Options::has(opt.suites, "concurrent_hash"))
+            {
+                runConcurrent<ConcurrentHashAdapter<K>>(opt, w, (Dist)d, results);
+                runConcurrent<LockedHashAdapter<K>>(opt, w, (Dist)d, results);
+            }
+            if (Options::has(opt.suites, "concurrent_avl"))
+            {
+                runConcurrent<ConcurrentAVLAdapter<K>>(opt, w, (Dist)d, results);
+                runConcurrent<LockedAVLAdapter<K>>(opt, w, (Dist)d, results);
+            }
+            if (Options::has(opt.suites, "insert_latency"))
+            {
+                runLatency<HashTableAdapter<K>>(opt, w, (Dist)d, results);
+                runLatency<IncrementalHashAdapter<K>>(opt, w, (Dist)d, results);
+                runLatency<UnorderedMapAdapter<K>>(opt, w, (Dist)d, results);
+            }
+            if (Options::has(opt.suites, "bulk_insert"))
+                runBulkInsert<K>(opt, w, (Dist)d, results);
+        }
+    }
+
+    const size_t hashNode = sizeof(HashNode<K, int>) + sizeof(void *); // nodo + bucket
+    const size_t treeNode = sizeof(NodeAVL<K>);
+    const double l2 = (double)cacheBytes(2), llc = (double)cacheBytes(3);
+    for (int d = 0; d < 4; ++d)
+    {
+        if (!Options::has(opt.dists, distNames[d]))
+            continue;
+        if (Options::has(opt.suites, "batch_lookup"))
+            for (size_t n : suiteSizes(opt, {keysFor(llc / 4, hashNode), keysFor(llc * 4, hashNode)}))
+                runBatchLookup<K>(opt, Workload<K>(n, (Dist)d, opt.seed), (Dist)d, results);
+        if (Options::has(opt.suites, "iteration"))
+            for (size_t n : suiteSizes(opt, {10000000}))
+                runIteration<K>(opt, n, (Dist)d, results);
+        if (Options::has(opt.suites, "frozen_lookup"))
+            for (size_t n : suiteSizes(opt, {keysFor(l2 / 2, treeNode), keysFor(llc / 2, treeNode),
+                                             keysFor(llc * 4, treeNode)}))
+                runFrozenLookup<K>(opt, n, (Dist)d, results);
+        if (Options::has(opt.suites, "parallel"))
+            for (size_t n : suiteSizes(opt, {10000000}))
+                runParallel<K>(opt, n, (Dist)d, results);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options opt;
+    if (argc == 2 && (string(argv[1]) == "--help" || string(argv[1]) == "-h"))
+    {
+        usage();
+        return 0;
+    }
+    if (!parseOptions(argc, argv, opt))
+    {
+        usage();
+        return 1;
+    }
+
+    vector<Result> results;
+    runKeyType<int64_t>(opt, results);
+    runKeyType<string>(opt, results);
+
+    if (opt.out.empty())
+    {
+        writeResults(cout, opt, results);
+        return 0;
+    }
+    ofstream file(opt.out);
+    if (!file)
+    {
+        cerr << "no se pudo abrir " << opt.out << endl;
+        return 1;
+    }
+    writeResults(file, opt, results);
+    return file ? 0 : 1;
+}
@@ -1,8 +1,55 @@
 #include <iostream>
+#include <cstdlib>
+#include <chrono>
+#include <string>
+#include <vector>
 
 int TotalAsserts = 0;
 int TrueAsserts = 0;
 
+// Modo silencioso (TESTER_QUIET=1 o TesterQuiet = true): solo se imprimen
+// los ASSERT que fallan y, al terminar, el resumen con los tiempos
+bool TesterQuiet = std::getenv("TESTER_QUIET") && std::string(std::getenv("TESTER_QUIET")) != "0";
+
+// Tiempos medidos con TestSection, en el orden en que terminaron
+std::vector<std::pair<std::string, double>> TesterTimings;
+
+// Mide el tiempo de un bloque: { TestSection s("avl insert"); ... }
+struct TestSection
+{
+    std::string name;
+    std::chrono::steady_clock::time_point start;
+
+    explicit TestSection(const std::string &_name) : name(_name), start(std::chrono::steady_clock::now()) {}
+
+    ~TestSection()
+    {
+        TesterTimings.emplace_back(name, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+};
+
+void TesterSummary()
+{
+    std::cerr << "Passed " << TrueAsserts << "/" << TotalAsserts << " asserts" << std::endl;
+    for (const auto &t : TesterTimings)
+        std::cerr << "  " << t.first << ": " << t.second * 1000 << " ms" << std::endl;
+}
+
+// 0 si todos los ASSERT pasaron (para retornar desde main)
+int TesterExitCode()
+{
+    return TrueAsserts == TotalAsserts ? 0 : 1;
+}
+
+struct TesterReport
+{
+    ~TesterReport()
+    {
+        if (TesterQuiet)
+            TesterSummary();
+    }
+} TesterAtExit;
+
 #ifndef NDEBUG
 #   define ASSERT(condition, message) \
     do { \
@@ -14,8 +61,9 @@ int TrueAsserts = 0;
         else { \
             TrueAsserts++; \
         } \
-        std::cerr <<"Success "<< TrueAsserts << "/" << TotalAsserts <<std::endl; \
+        if (!TesterQuiet) \
+            std::cerr <<"Success "<< TrueAsserts << "/" << TotalAsserts <<std::endl; \
     } while (false)
 #else
 #   define ASSERT(condition, message) do { } while (false)
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,311 @@
+/*
+ * Pruebas del AVLTree que main.cpp no cubre:
+ * 1. Copias de la clave al insertar: un insert copia o mueve la clave una
+ *    sola vez (tambien en PersistentAVLTree, que deriva sus nodos de NodeAVL).
+ * 2. count == 1 + left->count + right->count (y height, orden y balance) en
+ *    cada nodo despues de inserts y removes que fuerzan cada rotacion
+ *    LL/LR/RR/RL (confirmada con los contadores de DICT_STATS), y durante
+ *    operaciones al azar.
+ * 3. split/join al azar: el conjunto se parte en trozos que se vuelven a
+ *    cortar y a unir (por los dos lados); despues de cada paso cada trozo
+ *    esta balanceado y los trozos concatenados son el conjunto original.
+ * 4. Recorridos paralelos con 1..4 hilos y grano chico: parallel_reduce
+ *    (con un combine no conmutativo), parallel_for_each_indexed e
+ *    isBalanced dan lo mismo que el recorrido en orden de un solo hilo.
+ * Corre en modo silencioso: solo imprime los ASSERT que fallan y el resumen.
+ */
+#ifndef DICT_STATS
+#define DICT_STATS
+#endif
+
+#include <algorithm>
+#include <initializer_list>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "AVL.h"
+#include "PersistentAVLTree.h"
+#include "tester.h"
+
+using namespace std;
+
+// Clave que cuenta sus copias y movimientos
+struct Counted
+{
+    static int copies;
+    static int moves;
+    int v;
+
+    Counted(int _v = 0) : v(_v) {}
+    Counted(const Counted &other) : v(other.v) { ++copies; }
+    Counted(Counted &&other) noexcept : v(other.v) { ++moves; }
+    Counted &operator=(const Counted &other)
+    {
+        v = other.v;
+        ++copies;
+        return *this;
+    }
+    Counted &operator=(Counted &&other) noexcept
+    {
+        v = other.v;
+        ++moves;
+        return *this;
+    }
+
+    bool operator<(const Counted &other) const { return v < other.v; }
+    bool operator==(const Counted &other) const { return v == other.v; }
+
+    static void reset()
+    {
+        copies = 0;
+        moves = 0;
+    }
+};
+
+int Counted::copies = 0;
+int Counted::moves = 0;
+
+template <typename Tree>
+void keyCopies(const string &name)
+{
+    const int n = 1000;
+    Tree tree;
+
+    Counted::reset();
+    for (int i = 0; i < n; ++i)
+    {
+        Counted key(i);
+        tree.insert(key);
+    }
+    ASSERT(Counted::copies == n && Counted::moves == 0, name + ": insert(const T&) must copy the key once");
+
+    Counted::reset();
+    for (int i = n; i < 2 * n; ++i)
+        tree.insert(Counted(i));
+    ASSERT(Counted::copies == 0 && Counted::moves == n, name + ": insert(T&&) must move the key once");
+
+    ASSERT(tree.size() == 2 * n, name + ": insert lost keys");
+}
+
+/*Invariantes de count*/
+
+struct RotationCase
+{
+    string name;
+    vector<int> inserts;
+    int removed;      // -1: el caso es solo de inserts
+    string preOrder;  // forma esperada despues de la rotacion
+    size_t AVLTreeStats::*rotation;
+};
+
+void rotationCases()
+{
+    const RotationCase cases[] = {
+        {"insert LL", {3, 2, 1}, -1, "2 1 3 ", &AVLTreeStats::rotationsLL},
+        {"insert RR", {1, 2, 3}, -1, "2 1 3 ", &AVLTreeStats::rotationsRR},
+        {"insert LR", {3, 1, 2}, -1, "2 1 3 ", &AVLTreeStats::rotationsLR},
+        {"insert RL", {1, 3, 2}, -1, "2 1 3 ", &AVLTreeStats::rotationsRL},
+        {"remove LL", {3, 2, 4, 1}, 4, "2 1 3 ", &AVLTreeStats::rotationsLL},
+        {"remove RR", {2, 1, 3, 4}, 1, "3 2 4 ", &AVLTreeStats::rotationsRR},
+        {"remove LR", {3, 1, 4, 2}, 4, "2 1 3 ", &AVLTreeStats::rotationsLR},
+        {"remove RL", {2, 1, 4, 3}, 1, "3 2 4 ", &AVLTreeStats::rotationsRL},
+        // Dos hijos: sube el predecesor y el camino se rebalancea
+        {"remove two children", {5, 3, 8, 2, 4, 7, 9, 1}, 5, "4 2 1 3 8 7 9 ", &AVLTreeStats::rotationsLL},
+    };
+
+    for (const RotationCase &c : cases)
+    {
+        AVLTree<int> tree;
+        bool valid = true;
+        for (int k : c.inserts)
+        {
+            if (c.removed < 0)
+                tree.reset_stats();
+            tree.insert(k);
+            valid = valid && tree.checkInvariants();
+        }
+        if (c.removed >= 0)
+        {
+            tree.reset_stats();
+            tree.remove(c.removed);
+            valid = valid && tree.checkInvariants();
+        }
+        AVLTreeStats st = tree.stats();
+        ASSERT(valid, c.name + ": count/height invariant broken");
+        ASSERT(st.*c.rotation == 1, c.name + ": the expected rotation did not happen");
+        ASSERT(tree.getPreOrder() == c.preOrder, c.name + ": wrong shape " + tree.getPreOrder());
+    }
+}
+
+void randomOperations(mt19937_64 &rng)
+{
+    AVLTree<int> tree;
+    set<int> ref;
+    bool valid = true;
+    for (int i = 0; i < 20000; ++i)
+    {
+        int k = (int)(rng() % 2000);
+        if (rng() % 3)
+        {
+            tree.insert(k);
+            ref.insert(k);
+        }
+        else
+        {
+            tree.remove(k);
+            ref.erase(k);
+        }
+        if (i % 50 == 0)
+            valid = valid && tree.checkInvariants();
+    }
+    ASSERT(valid && tree.checkInvariants(), "count/height invariant broken by random operations");
+    ASSERT(tree.size() == (int)ref.size(), "size() differs from set");
+
+    // Tambien en sentido ascendente y descendente (rotaciones en cada insert)
+    AVLTree<int> up, down;
+    for (int k = 0; k < 5000; ++k)
+    {
+        up.insert(k);
+        down.insert(-k);
+    }
+    ASSERT(up.checkInvariants() && down.checkInvariants(), "count/height invariant broken by sorted inserts");
+    for (int k = 0; k < 5000; k += 2)
+    {
+        up.remove(k);
+        down.remove(-k);
+    }
+    ASSERT(up.checkInvariants() && down.checkInvariants() && up.size() == 2500, "count/height invariant broken by removes");
+}
+
+/*split y join*/
+
+vector<int> contents(AVLTree<int> &tree)
+{
+    vector<int> values;
+    tree.for_each_inorder([&](const int &v) { values.push_back(v); });
+    return values;
+}
+
+void splitJoinLoop(mt19937_64 &rng)
+{
+    TestSection s("split/join");
+    const int range = 20000;
+    set<int> ref;
+    vector<AVLTree<int>> pieces(1);
+    for (int i = 0; i < 3000; ++i)
+    {
+        int k = (int)(rng() % range);
+        pieces[0].insert(k);
+        ref.insert(k);
+    }
+
+    bool balanced = true, same = true, overlapRejected = true;
+    size_t maxPieces = 1;
+    for (int step = 0; step < 3000; ++step)
+    {
+        size_t i = (size_t)(rng() % pieces.size());
+        unsigned op = (unsigned)(rng() % 4);
+        if (op == 0 || pieces.size() == 1)
+        {
+            // Pivote al azar: puede estar o no en el arbol
+            AVLTree<int> right = pieces[i].split((int)(rng() % range));
+            pieces.insert(pieces.begin() + i + 1, std::move(right));
+        }
+        else if (op < 3 && i + 1 < pieces.size())
+        {
+            if (op == 1)
+                pieces[i].join(std::move(pieces[i + 1])); // las mayores a la derecha
+            else
+                pieces[i + 1].join(std::move(pieces[i])); // las menores a la izquierda
+            pieces.erase(pieces.begin() + (op == 1 ? i + 1 : i));
+        }
+        else
+        {
+            // Un join con rangos solapados se rechaza sin tocar los arboles
+            AVLTree<int> other;
+            other.insert((int)(rng() % range));
+            size_t before = (size_t)pieces[i].size();
+            bool overlaps = pieces[i].size() > 0 && pieces[i].minValue() <= other.minValue() &&
+                            other.minValue() <= pieces[i].maxValue();
+            if (overlaps)
+            {
+                try
+                {
+                    pieces[i].join(std::move(other));
+                    overlapRejected = false;
+                }
+                catch (const invalid_argument &)
+                {
+                }
+                overlapRejected = overlapRejected && (size_t)pieces[i].size() == before;
+            }
+        }
+
+        maxPieces = std::max(maxPieces, pieces.size());
+        vector<int> all;
+        for (AVLTree<int> &piece : pieces)
+        {
+            balanced = balanced && piece.isBalanced() && piece.checkInvariants();
+            vector<int> part = contents(piece);
+            all.insert(all.end(), part.begin(), part.end());
+        }
+        same = same && all == vector<int>(ref.begin(), ref.end());
+    }
+    ASSERT(balanced, "split/join left an unbalanced piece or a wrong count");
+    ASSERT(same, "split/join lost, duplicated or reordered keys");
+    ASSERT(overlapRejected, "join of overlapping ranges must throw and keep the tree");
+
+    AVLTree<int> whole;
+    for (AVLTree<int> &piece : pieces)
+        whole = AVLTree<int>::join(std::move(whole), std::move(piece));
+    ASSERT(maxPieces > 4, "The loop should split into several pieces");
+    ASSERT(whole.checkInvariants() && contents(whole) == vector<int>(ref.begin(), ref.end()), "Joining every piece must give the whole set back");
+}
+
+/*Recorridos paralelos*/
+
+void parallelTraversals(mt19937_64 &rng)
+{
+    AVLTree<int> tree;
+    for (int i = 0; i < 50000; ++i)
+        tree.insert((int)(rng() % 200000));
+    vector<int> expected = contents(tree);
+    string concatenated;
+    for (int v : expected)
+        concatenated += to_string(v % 10);
+
+    bool same = true;
+    for (unsigned threads = 1; threads <= 4; ++threads)
+    {
+        for (size_t grain : {(size_t)0, (size_t)64})
+        {
+            // Concatenar no es conmutativo: los parciales deben combinarse en orden
+            string digits = tree.parallel_reduce(
+                string(), [](const int &v) { return to_string(v % 10); },
+                [](string a, const string &b) { return a += b; }, threads, grain);
+            vector<int> indexed(expected.size(), -1);
+            tree.parallel_for_each_indexed([&](size_t i, const int &v) { indexed[i] = v; }, threads, grain);
+            same = same && digits == concatenated && indexed == expected && tree.isBalanced(threads);
+        }
+    }
+    ASSERT(same, "Parallel traversals differ from the in-order walk");
+    ASSERT(tree.isBalanced() && tree.isBalanced(0), "isBalanced differs between one and all threads");
+}
+
+int main()
+{
+    TesterQuiet = true;
+    mt19937_64 rng(12);
+
+    keyCopies<AVLTree<Counted>>("AVLTree");
+    keyCopies<PersistentAVLTree<Counted>>("PersistentAVLTree");
+    rotationCases();
+    randomOperations(rng);
+    splitJoinLoop(rng);
+    parallelTraversals(rng);
+
+    return TesterExitCode();
+}
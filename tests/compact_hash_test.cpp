@@ -0,0 +1,184 @@
+/*
+ * CompactHashTable contra la misma suite que test_hash() de main.cpp, mas:
+ * 1. Claves con los bits bajos en cero (i << 20), que sin mezclar el hash
+ *    caen todas en el mismo slot del indice.
+ * 2. remove() hasta forzar la compactacion del arreglo de entradas,
+ *    revisando que el orden de insercion se conserva.
+ * 3. Operaciones al azar contra std::unordered_map y una lista con el orden
+ *    de insercion esperado.
+ * Solo incluye CompactHashTable.h: el header debe compilar por si solo.
+ * Corre en modo silencioso: solo imprime los ASSERT que fallan y el resumen.
+ */
+#include <algorithm>
+#include <list>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "CompactHashTable.h"
+#include "tester.h"
+
+using namespace std;
+
+void test_hash()
+{
+    CompactHashTable<string, float> notas;
+    notas.insert("Nancy", 18);
+    notas.insert("Jorge", 10);
+    notas.insert("Maria", 15);
+    notas.insert("Pedro", 20);
+    notas.insert("Teofilo", 16);
+    notas.insert("Cecilia", 14);
+    notas.insert("Marcos", 11);
+    notas.insert(pair<string, float>("Ricardo", 12));
+    notas.insert(pair<string, float>("Dina", 8));
+    notas.insert(pair<string, float>("Ana", 19));
+    notas.insert(pair<string, float>("Cesar", 13));
+    notas.insert(pair<string, float>("Patricia", 17));
+
+    ASSERT(notas.getSize() == 12, "The compact hash table is not working");
+    ASSERT(notas.find("Marcos") == true, "The compact hash table is not working");
+    ASSERT(notas.find("Heider") == false, "The compact hash table is not working");
+    ASSERT(notas["Marcos"] == 11, "The compact hash table is not working");
+    notas["Marcos"] = 7;
+    ASSERT(notas.at("Marcos") == 7, "The compact hash table is not working");
+
+    string result = "";
+    CompactHashTable<string, float>::iterator iteh = notas.begin();
+    while (iteh != notas.end())
+    {
+        result += std::to_string((*iteh).first) + " ";
+        ++iteh;
+    }
+    ASSERT(result == "Nancy Jorge Maria Pedro Teofilo Cecilia Marcos Ricardo Dina Ana Cesar Patricia ", "The compact hash table is not working");
+
+    ASSERT(notas.remove("Heider") == false, "The compact hash table is not working");
+    ASSERT(notas.remove("Marcos") == true, "The compact hash table is not working");
+    ASSERT(notas.find("Marcos") == false, "The compact hash table is not working");
+    ASSERT(notas.getSize() == 11, "The compact hash table is not working");
+
+    bool threw = false;
+    try
+    {
+        notas.at("Marcos");
+    }
+    catch (const out_of_range &)
+    {
+        threw = true;
+    }
+    ASSERT(threw, "at() of a missing key must throw out_of_range");
+
+    // operator[] sobre una clave nueva la agrega al final con TV()
+    ASSERT(notas["Zoe"] == 0, "operator[] must insert TV()");
+    ASSERT(notas.getAllKeys().back() == "Zoe", "operator[] must append in insertion order");
+    ASSERT(notas.getSize() == 12, "operator[] must insert once");
+}
+
+void test_strided_keys()
+{
+    TestSection s("strided keys");
+    const long long n = 1 << 16;
+    CompactHashTable<long long, long long> table;
+    for (long long i = 0; i < n; ++i)
+        table.insert(i << 20, i);
+
+    bool found = true;
+    for (long long i = 0; i < n; ++i)
+        found = found && table.find(i << 20) && table.at(i << 20) == i;
+    ASSERT(found, "Strided keys must be found");
+    ASSERT(!table.find(1), "A missing key must not be found");
+    ASSERT(table.getSize() == n, "Strided keys must all be kept");
+}
+
+void test_compaction()
+{
+    CompactHashTable<int, int> table;
+    for (int i = 0; i < 1000; ++i)
+        table.insert(i, i * 10);
+    // Elimina los pares: la mitad del arreglo queda en lapidas y se compacta
+    for (int i = 0; i < 1000; i += 2)
+        table.remove(i);
+
+    vector<int> expected;
+    for (int i = 1; i < 1000; i += 2)
+        expected.push_back(i);
+    ASSERT(table.getAllKeys() == expected, "Compaction must keep insertion order");
+
+    bool values = true;
+    for (auto it = table.begin(); it != table.end(); ++it)
+        values = values && it->second == it->first * 10;
+    ASSERT(values, "Compaction must keep the values");
+
+    // Las claves eliminadas se pueden volver a insertar y van al final
+    table.insert(0, 7);
+    ASSERT(table.getAllKeys().back() == 0 && table.at(0) == 7, "A reinserted key must go to the end");
+}
+
+void differential(size_t n, mt19937_64 &rng)
+{
+    CompactHashTable<string, int> table;
+    unordered_map<string, int> ref;
+    list<string> order;
+    uint64_t range = 2 * n;
+
+    bool same = true;
+    for (size_t i = 0; i < 3 * n; ++i)
+    {
+        string key = "k" + to_string(rng() % range);
+        int value = (int)(rng() % 1000);
+        unsigned op = (unsigned)(rng() % 5);
+        if (op < 2)
+        {
+            if (!ref.count(key))
+                order.push_back(key);
+            table.insert(key, value);
+            ref[key] = value;
+        }
+        else if (op == 2)
+        {
+            if (!ref.count(key))
+                order.push_back(key);
+            table[key] += value;
+            ref[key] += value;
+        }
+        else if (op == 3)
+        {
+            if (table.remove(key) != (ref.erase(key) == 1))
+                same = false;
+            order.remove(key);
+        }
+        else if (table.find(key) != (ref.count(key) == 1) ||
+                 (ref.count(key) && table.at(key) != ref[key]))
+        {
+            same = false;
+        }
+    }
+    ASSERT(same, "CompactHashTable differs from unordered_map");
+    ASSERT(table.getSize() == (int)ref.size(), "CompactHashTable size differs");
+
+    vector<pair<string, int>> expected;
+    for (const string &key : order)
+        expected.emplace_back(key, ref[key]);
+    ASSERT(table.getAllElements() == expected, "CompactHashTable lost the insertion order");
+
+    vector<pair<string, int>> iterated;
+    for (auto it = table.begin(); it != table.end(); ++it)
+        iterated.push_back(*it);
+    ASSERT(iterated == expected, "The iterator must follow the insertion order");
+}
+
+int main()
+{
+    TesterQuiet = true;
+    mt19937_64 rng(2024);
+
+    test_hash();
+    test_strided_keys();
+    test_compaction();
+    {
+        TestSection s("differential");
+        for (size_t n : {100, 1000, 5000})
+            differential(n, rng);
+    }
+    return TesterExitCode();
+}
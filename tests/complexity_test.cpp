@@ -0,0 +1,901 @@
+/*
+ * Pruebas diferenciales y de complejidad empirica:
+ * 1. Operaciones al azar contra std::set / std::unordered_map en tamanos
+ *    crecientes, revisando las invariantes del AVL (balance, altura,
+ *    rank/select, split/join) y el orden de insercion del HashTable, con
+ *    std::allocator y con PoolAllocator (NodePool), y el HashTable tambien
+ *    con rehashing incremental. Ademas: unite/intersect/difference/
+ *    is_subset contra los algoritmos de <algorithm>, lower_bound/range/
+ *    prefix, assign_sorted/insert_bulk, insert_many/find_many/try_emplace y
+ *    el volcado con KeyWriter (buffer chico, string y ostream). Los
+ *    contenedores se mueven sin lanzar (vector los mueve al crecer) y el
+ *    HashTable movido queda vacio y se puede volver a usar.
+ * 2. Tiempo por operacion en n = 4K..256K: se reporta la pendiente de
+ *    log(t(n) / f(n)) contra log n, con f la complejidad esperada, y falla
+ *    si la pendiente contra std::set / std::unordered_map con la misma carga
+ *    indica crecimiento superlineal (un arbol que no rebalancea o un
+ *    rehashing demasiado frecuente dan pendiente ~1).
+ * 3. Con los contadores de DICT_STATS: cantidad de rehashing, largo de
+ *    sondeo y rotaciones por insert acotados.
+ * Corre en modo silencioso: solo imprime los ASSERT que fallan y el resumen.
+ */
+#ifndef DICT_STATS
+#define DICT_STATS
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "AVL.h"
+#include "HashTable.h"
+#include "KeyWriter.h"
+#include "NodePool.h"
+#include "tester.h"
+
+using namespace std;
+
+static volatile size_t sink; // evita que el compilador descarte las busquedas
+
+template <typename K>
+K makeKey(uint64_t x);
+
+template <>
+int makeKey<int>(uint64_t x)
+{
+    return (int)x;
+}
+
+template <>
+string makeKey<string>(uint64_t x)
+{
+    return "k" + to_string(x);
+}
+
+/*Diferenciales*/
+
+template <typename K, typename Alloc = allocator<K>>
+void differentialAVL(size_t n, mt19937_64 &rng)
+{
+    AVLTree<K, Alloc> tree;
+    set<K> ref;
+    uint64_t range = 2 * n;
+
+    bool same = true;
+    for (size_t i = 0; i < 3 * n; ++i)
+    {
+        K key = makeKey<K>(rng() % range);
+        unsigned op = (unsigned)(rng() % 4);
+        if (op < 2)
+        {
+            tree.insert(key);
+            ref.insert(key);
+        }
+        else if (op == 2)
+        {
+            tree.remove(key);
+            ref.erase(key);
+        }
+        else if (tree.find(key) != (ref.count(key) == 1))
+        {
+            same = false;
+        }
+    }
+    ASSERT(same, "AVL find differs from std::set (n=" << n << ")");
+    ASSERT((size_t)tree.size() == ref.size(), "AVL size differs from std::set (n=" << n << ")");
+    ASSERT(tree.isBalanced(), "AVL is not balanced (n=" << n << ")");
+    // Un AVL con m nodos tiene altura < 1.4405 log2(m + 2)
+    ASSERT(tree.height() <= 1.4405 * log2((double)ref.size() + 2), "AVL is too tall (n=" << n << ")");
+
+    vector<K> inorder;
+    tree.for_each_inorder([&inorder](const K &key) { inorder.push_back(key); });
+    ASSERT(equal(inorder.begin(), inorder.end(), ref.begin(), ref.end()), "AVL in-order differs from std::set (n=" << n << ")");
+
+    bool ranks = true;
+    size_t pos = 0;
+    for (const K &key : ref)
+    {
+        if (tree.select(pos) != key || tree.rank(key) != pos)
+            ranks = false;
+        pos++;
+    }
+    ASSERT(ranks, "AVL rank/select inconsistent (n=" << n << ")");
+
+    bool neighbours = true;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        K key = makeKey<K>(rng() % range);
+        K out;
+        auto next = ref.upper_bound(key);
+        if (tree.successor(key, out) != (next != ref.end()) || (next != ref.end() && out != *next))
+            neighbours = false;
+        auto low = ref.lower_bound(key);
+        bool hasPrev = low != ref.begin();
+        if (tree.predecessor(key, out) != hasPrev || (hasPrev && out != *prev(low)))
+            neighbours = false;
+    }
+    ASSERT(neighbours, "AVL successor/predecessor differ from std::set (n=" << n << ")");
+
+    K pivot = makeKey<K>(rng() % range);
+    size_t below = (size_t)distance(ref.begin(), ref.lower_bound(pivot));
+    AVLTree<K, Alloc> right = tree.split(pivot);
+    ASSERT((size_t)tree.size() == below && (size_t)right.size() == ref.size() - below,
+           "AVL split sizes are wrong (n=" << n << ")");
+    ASSERT(tree.isBalanced() && right.isBalanced(), "AVL split is not balanced (n=" << n << ")");
+    ASSERT((tree.size() == 0 || tree.maxValue() < pivot) && (right.size() == 0 || !(right.minValue() < pivot)),
+           "AVL split put keys on the wrong side (n=" << n << ")");
+    tree.join(std::move(right));
+    inorder.clear();
+    tree.for_each_inorder([&inorder](const K &key) { inorder.push_back(key); });
+    ASSERT(tree.isBalanced() && equal(inorder.begin(), inorder.end(), ref.begin(), ref.end()),
+           "AVL join did not restore the tree (n=" << n << ")");
+}
+
+template <typename K, typename Alloc = allocator<pair<const K, int>>>
+void differentialHash(size_t n, mt19937_64 &rng, bool incremental = false)
+{
+    HashTable<K, int, Alloc> table;
+    table.incremental_rehash(incremental);
+    unordered_map<K, int> ref;
+    list<K> order; // orden de insercion esperado
+    unordered_map<K, typename list<K>::iterator> where;
+    uint64_t range = 2 * n;
+
+    bool same = true;
+    for (size_t i = 0; i < 3 * n; ++i)
+    {
+        K key = makeKey<K>(rng() % range);
+        int value = (int)(rng() % 1000);
+        unsigned op = (unsigned)(rng() % 4);
+        if (op < 2)
+        {
+            table.insert(key, value);
+            if (ref.find(key) == ref.end())
+                where[key] = order.insert(order.end(), key);
+            ref[key] = value;
+        }
+        else if (op == 2)
+        {
+            bool removed = ref.erase(key) == 1;
+            if (table.remove(key) != removed)
+                same = false;
+            if (removed)
+            {
+                order.erase(where[key]);
+                where.erase(key);
+            }
+        }
+        else
+        {
+            auto it = ref.find(key);
+            if (table.find(key) != (it != ref.end()) || (it != ref.end() && table.at(key) != it->second))
+                same = false;
+        }
+    }
+    ASSERT(same, "HashTable differs from std::unordered_map (n=" << n << ")");
+    ASSERT(table.getSize() == ref.size(), "HashTable size differs (n=" << n << ")");
+    vector<K> keys = table.getAllKeys();
+    ASSERT(equal(keys.begin(), keys.end(), order.begin(), order.end()), "HashTable lost insertion order (n=" << n << ")");
+
+    bool missing = false;
+    try
+    {
+        table.at(makeKey<K>(range + 1));
+    }
+    catch (const out_of_range &)
+    {
+        missing = true;
+    }
+    ASSERT(missing, "HashTable::at does not throw for a missing key");
+}
+
+template <typename K, typename Tree>
+vector<K> inOrder(Tree &tree)
+{
+    vector<K> keys;
+    tree.for_each_inorder([&keys](const K &key) { keys.push_back(key); });
+    return keys;
+}
+
+template <typename K, typename Tree>
+void fillRandom(Tree &tree, set<K> &ref, size_t m, uint64_t range, mt19937_64 &rng)
+{
+    for (size_t i = 0; i < m; ++i)
+    {
+        K key = makeKey<K>(rng() % range);
+        tree.insert(key);
+        ref.insert(key);
+    }
+}
+
+/*Algebra de conjuntos contra set_union/set_intersection/set_difference/
+  includes. Todos los arboles usan alloc; el unite por movimiento se prueba
+  tambien con un allocator distinto (con PoolAllocator copia los nodos)*/
+template <typename K, typename Alloc = allocator<K>>
+void differentialSetAlgebra(size_t n, mt19937_64 &rng, const Alloc &alloc = Alloc())
+{
+    typedef AVLTree<K, Alloc> Tree;
+    uint64_t range = 2 * n;
+    Tree a(alloc), b(alloc);
+    set<K> ra, rb;
+    fillRandom<K>(a, ra, n, range, rng);
+    fillRandom<K>(b, rb, n / 4 + 1, range, rng); // m << n: el camino O(m log(n/m))
+
+    auto valid = [](Tree &tree, const vector<K> &expected) {
+        return tree.isBalanced() && tree.checkInvariants() && (size_t)tree.size() == expected.size() &&
+               inOrder<K>(tree) == expected;
+    };
+    vector<K> expected;
+
+    Tree u(a);
+    u.unite(b);
+    set_union(ra.begin(), ra.end(), rb.begin(), rb.end(), back_inserter(expected));
+    ASSERT(valid(u, expected), "AVL unite differs from set_union (n=" << n << ")");
+
+    Tree shared(b), fresh((Alloc()));
+    for (const K &key : rb)
+        fresh.insert(key);
+    Tree um(a), um2(a);
+    um.unite(std::move(shared));
+    um2.unite(std::move(fresh));
+    ASSERT(valid(um, expected) && valid(um2, expected) && shared.size() == 0,
+           "AVL unite by move differs from set_union (n=" << n << ")");
+
+    Tree both(a);
+    both.intersect(b);
+    expected.clear();
+    set_intersection(ra.begin(), ra.end(), rb.begin(), rb.end(), back_inserter(expected));
+    ASSERT(valid(both, expected), "AVL intersect differs from set_intersection (n=" << n << ")");
+
+    Tree rest(a);
+    rest.difference(b);
+    expected.clear();
+    set_difference(ra.begin(), ra.end(), rb.begin(), rb.end(), back_inserter(expected));
+    ASSERT(valid(rest, expected), "AVL difference differs from set_difference (n=" << n << ")");
+
+    // Con uno mismo: unite no cambia, intersect tampoco, difference vacia
+    Tree self(b);
+    self.unite(self);
+    self.intersect(self);
+    ASSERT(valid(self, vector<K>(rb.begin(), rb.end())), "AVL set algebra with itself changed the tree");
+    self.difference(self);
+    ASSERT(self.size() == 0, "AVL difference with itself must be empty");
+
+    bool subsets = a.is_subset(b) == includes(rb.begin(), rb.end(), ra.begin(), ra.end()) &&
+                   b.is_subset(a) == includes(ra.begin(), ra.end(), rb.begin(), rb.end()) &&
+                   both.is_subset(a) && both.is_subset(b) && a.is_subset(u) && b.is_subset(u) &&
+                   rest.is_subset(b) == (rest.size() == 0) && self.is_subset(a);
+    // Un subconjunto de b con una clave que falta deja de serlo
+    Tree almost(b);
+    K outside = makeKey<K>(range + 1);
+    almost.insert(outside);
+    subsets = subsets && !almost.is_subset(b) && b.is_subset(almost);
+    ASSERT(subsets, "AVL is_subset differs from includes (n=" << n << ")");
+}
+
+template <typename K>
+void differentialRanges(size_t n, mt19937_64 &rng)
+{
+    uint64_t range = 2 * n;
+    AVLTree<K> tree;
+    set<K> ref;
+    fillRandom<K>(tree, ref, n, range, rng);
+
+    bool bounds = true, ranges = true;
+    for (size_t i = 0; i < 500; ++i)
+    {
+        K lo = makeKey<K>(rng() % (range + 2)), hi = makeKey<K>(rng() % (range + 2));
+        auto it = tree.lower_bound(lo);
+        auto want = ref.lower_bound(lo);
+        bounds = bounds && (it != tree.end()) == (want != ref.end()) && (want == ref.end() || *it == *want);
+        auto up = tree.upper_bound(lo);
+        auto wantUp = ref.upper_bound(lo);
+        bounds = bounds && (up != tree.end()) == (wantUp != ref.end()) && (wantUp == ref.end() || *up == *wantUp);
+
+        vector<K> got;
+        for (const K &key : tree.range(lo, hi))
+            got.push_back(key);
+        vector<K> expected;
+        if (!(hi < lo))
+            expected.assign(ref.lower_bound(lo), ref.upper_bound(hi));
+        ranges = ranges && got == expected;
+    }
+    ASSERT(bounds, "AVL lower_bound/upper_bound differ from std::set (n=" << n << ")");
+    ASSERT(ranges, "AVL range differs from std::set (n=" << n << ")");
+
+    if constexpr (is_same<K, string>::value)
+    {
+        // Prefijos de claves existentes, uno vacio, uno que no esta y "k\xff"
+        vector<string> prefixes{"", "k", "x", string("k") + (char)0xFF};
+        for (size_t i = 0; i < 200; ++i)
+        {
+            string key = makeKey<K>(rng() % range);
+            prefixes.push_back(key.substr(0, 1 + rng() % key.size()));
+        }
+        tree.insert(string("k") + (char)0xFF + "z");
+        ref.insert(string("k") + (char)0xFF + "z");
+
+        bool same = true;
+        for (const string &p : prefixes)
+        {
+            vector<string> got, expected;
+            for (const string &key : tree.prefix(p))
+                got.push_back(key);
+            for (const string &key : ref)
+                if (key.compare(0, p.size(), p) == 0)
+                    expected.push_back(key);
+            same = same && got == expected;
+        }
+        ASSERT(same, "AVL prefix differs from a filter over std::set (n=" << n << ")");
+    }
+}
+
+template <typename K>
+void differentialBulk(size_t n, mt19937_64 &rng)
+{
+    uint64_t range = 2 * n;
+    auto sortedBatch = [&](size_t m) {
+        vector<K> keys;
+        for (size_t i = 0; i < m; ++i)
+            keys.push_back(makeKey<K>(rng() % range)); // con repetidos
+        sort(keys.begin(), keys.end());
+        return keys;
+    };
+    auto valid = [](AVLTree<K> &tree, const set<K> &ref) {
+        return tree.isBalanced() && tree.checkInvariants() && (size_t)tree.size() == ref.size() &&
+               inOrder<K>(tree) == vector<K>(ref.begin(), ref.end());
+    };
+
+    vector<K> keys = sortedBatch(n);
+    set<K> ref(keys.begin(), keys.end());
+    AVLTree<K> tree;
+    tree.assign_sorted(keys.begin(), keys.end());
+    ASSERT(valid(tree, ref), "AVL assign_sorted differs from std::set (n=" << n << ")");
+    // Un arbol de log n niveles completo: la altura minima
+    ASSERT(tree.height() <= (int)log2((double)ref.size()) + 1, "AVL assign_sorted is not minimal height (n=" << n << ")");
+
+    // Un lote chico se inserta uno por uno, uno grande se mezcla
+    bool same = true;
+    for (size_t m : {n / 100 + 1, n, 3 * n})
+    {
+        vector<K> batch = sortedBatch(m);
+        tree.insert_bulk(batch.begin(), batch.end());
+        ref.insert(batch.begin(), batch.end());
+        same = same && valid(tree, ref);
+    }
+    AVLTree<K> empty;
+    empty.insert_bulk(keys.begin(), keys.end());
+    same = same && valid(empty, set<K>(keys.begin(), keys.end()));
+    ASSERT(same, "AVL insert_bulk differs from std::set (n=" << n << ")");
+
+    // Lote desordenado: insert_bulk no toca el arbol, assign_sorted lo vacia
+    vector<K> unsorted{makeKey<K>(2), makeKey<K>(1)};
+    bool threw = false;
+    try
+    {
+        tree.insert_bulk(unsorted.begin(), unsorted.end());
+    }
+    catch (const invalid_argument &)
+    {
+        threw = true;
+    }
+    ASSERT(threw && valid(tree, ref), "AVL insert_bulk of an unsorted range must throw and keep the tree");
+    threw = false;
+    try
+    {
+        tree.assign_sorted(unsorted.begin(), unsorted.end());
+    }
+    catch (const invalid_argument &)
+    {
+        threw = true;
+    }
+    ASSERT(threw && tree.size() == 0, "AVL assign_sorted of an unsorted range must throw and leave it empty");
+}
+
+/*insert_many, try_emplace, remove y find_many mezclados, con o sin rehashing
+  incremental (los lotes caen en medio de la migracion)*/
+template <typename K>
+void differentialHashBatch(size_t n, mt19937_64 &rng, bool incremental)
+{
+    HashTable<K, int> table;
+    table.incremental_rehash(incremental);
+    unordered_map<K, int> ref;
+    uint64_t range = 2 * n;
+
+    bool many = true, emplaced = true, removed = true, found = true;
+    for (int round = 0; round < 20; ++round)
+    {
+        vector<pair<K, int>> items;
+        for (size_t i = 0; i < n / 10; ++i)
+            items.emplace_back(makeKey<K>(rng() % range), (int)(rng() % 1000));
+        table.insert_many(items.begin(), items.end()); // sobrescribe como insert
+        for (auto &item : items)
+            ref[item.first] = item.second;
+        many = many && table.getSize() == ref.size();
+
+        for (size_t i = 0; i < n / 20; ++i)
+        {
+            K key = makeKey<K>(rng() % range);
+            int value = (int)(rng() % 1000) + 1000;
+            auto r = table.try_emplace(key, value);
+            bool fresh = ref.emplace(key, value).second;
+            emplaced = emplaced && r.second == fresh && (*r.first).second == ref[key];
+        }
+
+        for (size_t i = 0; i < n / 20; ++i)
+        {
+            K key = makeKey<K>(rng() % range);
+            removed = removed && table.remove(key) == (ref.erase(key) == 1);
+        }
+
+        vector<K> queries;
+        for (size_t i = 0; i < n / 10; ++i)
+            queries.push_back(makeKey<K>(rng() % (2 * range))); // la mitad fallan
+        vector<int *> out(queries.size());
+        size_t hits = table.find_many(queries.data(), queries.size(), out.data());
+        size_t expectedHits = 0;
+        for (size_t i = 0; i < queries.size(); ++i)
+        {
+            auto it = ref.find(queries[i]);
+            expectedHits += it != ref.end();
+            found = found && (out[i] ? it != ref.end() && *out[i] == it->second : it == ref.end());
+        }
+        vector<int *> again = table.find_many(queries);
+        found = found && hits == expectedHits && again == out;
+    }
+    string mode = incremental ? " incremental" : "";
+    ASSERT(many, "HashTable" << mode << " insert_many size differs (n=" << n << ")");
+    ASSERT(emplaced, "HashTable" << mode << " try_emplace differs from emplace (n=" << n << ")");
+    ASSERT(removed, "HashTable" << mode << " remove differs (n=" << n << ")");
+    ASSERT(found, "HashTable" << mode << " find_many differs from std::unordered_map (n=" << n << ")");
+    ASSERT(table.getSize() == ref.size(), "HashTable" << mode << " size differs after batches (n=" << n << ")");
+}
+
+/*Volcado con KeyWriter: un buffer de 64 bytes se vacia muchas veces, en
+  medio de los recorridos; la salida debe ser la de operator<<*/
+template <typename K>
+void differentialKeyWriter(size_t n, mt19937_64 &rng)
+{
+    AVLTree<K> tree;
+    set<K> ref;
+    fillRandom<K>(tree, ref, n, 2 * n, rng);
+    if constexpr (is_same<K, string>::value)
+    {
+        tree.insert(string(300, 'z')); // mas largo que el buffer
+        ref.insert(string(300, 'z'));
+    }
+    else
+    {
+        tree.insert(-123456789);
+        ref.insert(-123456789);
+    }
+
+    auto joined = [](const vector<K> &keys, const string &sep) {
+        ostringstream out;
+        for (const K &key : keys)
+            out << key << sep;
+        return out.str();
+    };
+    vector<K> pre, post;
+    tree.for_each_preorder([&pre](const K &key) { pre.push_back(key); });
+    tree.for_each_postorder([&post](const K &key) { post.push_back(key); });
+
+    string viaString, preString, postString;
+    {
+        KeyWriter out(viaString, 64, ", ");
+        tree.write_inorder(out);
+    } // el destructor vacia lo que queda
+    ostringstream viaStream;
+    {
+        KeyWriter out(viaStream, 64, ", ");
+        tree.write_inorder(out);
+        out.flush();
+    }
+    {
+        KeyWriter outPre(preString, 64), outPost(postString, 64);
+        tree.write_preorder(outPre);
+        tree.write_postorder(outPost);
+    }
+    string expected = joined(vector<K>(ref.begin(), ref.end()), ", ");
+    ASSERT(viaString == expected && viaStream.str() == expected, "KeyWriter in-order output differs (n=" << n << ")");
+    ASSERT(preString == joined(pre, " ") && postString == joined(post, " "),
+           "KeyWriter pre/post-order output differs (n=" << n << ")");
+    ASSERT(tree.getInOrder() == joined(vector<K>(ref.begin(), ref.end()), " "), "getInOrder differs (n=" << n << ")");
+}
+
+/*Movimientos: con noexcept vector y move_if_noexcept mueven en vez de copiar*/
+static_assert(is_nothrow_move_constructible<HashTable<int, int>>::value, "HashTable move must be noexcept");
+static_assert(is_nothrow_move_constructible<HashTable<string, int, PoolAllocator<pair<const string, int>>>>::value,
+              "HashTable move with PoolAllocator must be noexcept");
+static_assert(is_nothrow_move_constructible<AVLTree<int>>::value, "AVLTree move must be noexcept");
+static_assert(is_nothrow_move_constructible<AVLTree<string, PoolAllocator<string>>>::value,
+              "AVLTree move with PoolAllocator must be noexcept");
+
+template <typename Alloc>
+void differentialMoves()
+{
+    typedef HashTable<int, int, Alloc> Table;
+
+    // Al crecer el vector las tablas se mueven: los valores no cambian de lugar
+    vector<Table> tables;
+    vector<int *> where;
+    for (int t = 0; t < 40; ++t)
+    {
+        tables.emplace_back();
+        for (int i = 0; i < 100; ++i)
+            tables.back().insert(t * 1000 + i, i);
+        where.push_back(&tables.back().at(t * 1000));
+    }
+    bool kept = true;
+    for (int t = 0; t < 40; ++t)
+        kept = kept && tables[t].getSize() == 100 && &tables[t].at(t * 1000) == where[t] &&
+               tables[t].at(t * 1000 + 99) == 99;
+    ASSERT(kept, "Growing a vector of HashTable must move the tables, not copy them");
+
+    for (bool incremental : {false, true})
+    {
+        Table source;
+        source.incremental_rehash(incremental);
+        for (int i = 0; i < 1000; ++i)
+            source.insert(i, i);
+        Table moved(std::move(source));
+
+        // La tabla movida esta vacia y acepta cualquier operacion
+        bool empty = source.getSize() == 0 && !source.find(5) && !source.remove(5) && source.getAllKeys().empty();
+        source.clear();
+        source.shrink_to_fit();
+        source.reserve(0);
+        vector<int> order;
+        for (int i = 0; i < 1000; ++i)
+        {
+            int k = (i * 7919) % 1000;
+            source.insert(k, -k);
+            order.push_back(k);
+        }
+        bool reused = source.getSize() == 1000 && source.getAllKeys() == order;
+        for (int i = 0; i < 1000; ++i)
+            reused = reused && source.at(i) == -i && moved.at(i) == i;
+        ASSERT(empty && reused, "A moved-from HashTable must be empty and reusable (incremental " << incremental << ")");
+
+        Table again(std::move(moved));
+        again = std::move(source);
+        ASSERT(moved.getSize() == 0 && again.getSize() == 1000 && again.at(3) == -3, "HashTable move assignment failed");
+        moved.insert(1, 1);
+        ASSERT(moved.getSize() == 1 && moved.at(1) == 1, "Inserting into a moved-from HashTable failed");
+    }
+}
+
+/*Complejidad empirica*/
+
+// Pendiente de minimos cuadrados de log(y) contra log(x)
+double logSlope(const vector<double> &x, const vector<double> &y)
+{
+    double mx = 0, my = 0;
+    for (size_t i = 0; i < x.size(); ++i)
+    {
+        mx += log(x[i]);
+        my += log(y[i]);
+    }
+    mx /= (double)x.size();
+    my /= (double)y.size();
+    double num = 0, den = 0;
+    for (size_t i = 0; i < x.size(); ++i)
+    {
+        num += (log(x[i]) - mx) * (log(y[i]) - my);
+        den += (log(x[i]) - mx) * (log(x[i]) - mx);
+    }
+    return num / den;
+}
+
+const size_t MinN = 1 << 12;
+const size_t MaxN = 1 << 18;
+
+// La pendiente se mide sobre el cociente contra el contenedor de la STL con
+// la misma carga: asi se cancelan los efectos de cache, que solos llevan una
+// curva correcta a ~0.4. Un arbol sin rebalanceo o un rehashing por cada
+// insert dan ~1 (O(n) por operacion)
+const double MaxSlope = 0.5;
+
+/*measure(n) y baseline(n) retornan ns por operacion con n elementos (se
+  toma el minimo de 3 corridas); expected(n) es la complejidad esperada por
+  operacion, solo para el reporte*/
+void checkGrowth(const string &name, double (*measure)(size_t), double (*baseline)(size_t), double (*expected)(size_t))
+{
+    TestSection section(name);
+    vector<double> sizes, normalized, relative;
+    string curve;
+    for (size_t n = MinN; n <= MaxN; n *= 4)
+    {
+        double best = 0, base = 0;
+        for (int rep = 0; rep < 3; ++rep)
+        {
+            double ns = measure(n), bs = baseline(n);
+            best = rep == 0 ? ns : min(best, ns);
+            base = rep == 0 ? bs : min(base, bs);
+        }
+        sizes.push_back((double)n);
+        normalized.push_back(best / expected(n));
+        relative.push_back(best / base);
+        curve += " " + to_string(n) + ":" + to_string((int)best) + "ns";
+    }
+    double slope = logSlope(sizes, relative);
+    cerr << name << " ->" << curve << " | slope vs f(n) " << logSlope(sizes, normalized)
+         << ", vs STL " << slope << endl;
+    ASSERT(slope < MaxSlope, name << " grows faster than expected (slope vs STL " << slope << ")");
+}
+
+double constant(size_t)
+{
+    return 1;
+}
+
+double logarithmic(size_t n)
+{
+    return log2((double)n);
+}
+
+template <typename F>
+double nsPerOp(size_t ops, F f)
+{
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / (double)ops;
+}
+
+vector<int> shuffledKeys(size_t n, uint64_t seed)
+{
+    vector<int> keys(n);
+    for (size_t i = 0; i < n; ++i)
+        keys[i] = (int)i;
+    mt19937_64 rng(seed);
+    shuffle(keys.begin(), keys.end(), rng);
+    return keys;
+}
+
+// Misma interfaz para los contenedores propios y los de la STL
+bool contains(AVLTree<int> &tree, int key) { return tree.find(key); }
+bool contains(set<int> &tree, int key) { return tree.count(key) == 1; }
+void erase(AVLTree<int> &tree, int key) { tree.remove(key); }
+void erase(set<int> &tree, int key) { tree.erase(key); }
+
+template <typename K>
+bool contains(HashTable<K, int> &table, K key) { return table.find(key); }
+template <typename K>
+bool contains(unordered_map<K, int> &table, K key) { return table.count(key) == 1; }
+template <typename K>
+void put(HashTable<K, int> &table, K key) { table.insert(key, 1); }
+template <typename K>
+void put(unordered_map<K, int> &table, K key) { table.emplace(key, 1); }
+template <typename K>
+void erase(HashTable<K, int> &table, K key) { table.remove(key); }
+template <typename K>
+void erase(unordered_map<K, int> &table, K key) { table.erase(key); }
+
+template <typename Tree>
+double treeInsertRandom(size_t n)
+{
+    vector<int> keys = shuffledKeys(n, n);
+    Tree tree;
+    return nsPerOp(n, [&] {
+        for (int key : keys)
+            tree.insert(key);
+    });
+}
+
+// Sin rebalanceo las claves en orden degeneran en una lista
+template <typename Tree>
+double treeInsertAscending(size_t n)
+{
+    Tree tree;
+    return nsPerOp(n, [&] {
+        for (size_t i = 0; i < n; ++i)
+            tree.insert((int)i);
+    });
+}
+
+template <typename Tree>
+double treeFind(size_t n)
+{
+    vector<int> keys = shuffledKeys(n, n + 1);
+    Tree tree;
+    for (size_t i = 0; i < n; ++i)
+        tree.insert((int)i);
+    return nsPerOp(n, [&] {
+        size_t found = 0;
+        for (int key : keys)
+            found += contains(tree, key);
+        sink += found;
+    });
+}
+
+template <typename Tree>
+double treeRemove(size_t n)
+{
+    vector<int> keys = shuffledKeys(n, n + 2);
+    Tree tree;
+    for (size_t i = 0; i < n; ++i)
+        tree.insert((int)i);
+    return nsPerOp(n, [&] {
+        for (int key : keys)
+            erase(tree, key);
+    });
+}
+
+template <typename Table>
+double hashInsert(size_t n)
+{
+    vector<int> keys = shuffledKeys(n, n);
+    Table table;
+    return nsPerOp(n, [&] {
+        for (int key : keys)
+            put(table, key);
+    });
+}
+
+template <typename Table>
+double hashFind(size_t n)
+{
+    vector<int> keys = shuffledKeys(n, n + 1);
+    Table table;
+    for (int key : keys)
+        put(table, key);
+    return nsPerOp(n, [&] {
+        size_t found = 0;
+        for (int key : keys)
+            found += contains(table, key);
+        sink += found;
+    });
+}
+
+// Claves con los bits bajos iguales: sin mezclar el hash caen en un bucket
+template <typename Table>
+double hashInsertColliding(size_t n)
+{
+    Table table;
+    return nsPerOp(n, [&] {
+        for (size_t i = 0; i < n; ++i)
+            put(table, (long long)i << 24);
+    });
+}
+
+template <typename Table>
+double hashRemove(size_t n)
+{
+    vector<int> keys = shuffledKeys(n, n + 2);
+    Table table;
+    for (int key : keys)
+        put(table, key);
+    return nsPerOp(n, [&] {
+        for (int key : keys)
+            erase(table, key);
+    });
+}
+
+void complexityAVL()
+{
+    checkGrowth("avl insert random", treeInsertRandom<AVLTree<int>>, treeInsertRandom<set<int>>, logarithmic);
+    checkGrowth("avl insert ascending", treeInsertAscending<AVLTree<int>>, treeInsertAscending<set<int>>, logarithmic);
+    checkGrowth("avl find", treeFind<AVLTree<int>>, treeFind<set<int>>, logarithmic);
+    checkGrowth("avl remove", treeRemove<AVLTree<int>>, treeRemove<set<int>>, logarithmic);
+}
+
+void complexityHash()
+{
+    checkGrowth("hash insert", hashInsert<HashTable<int, int>>, hashInsert<unordered_map<int, int>>, constant);
+    checkGrowth("hash find", hashFind<HashTable<int, int>>, hashFind<unordered_map<int, int>>, constant);
+    checkGrowth("hash insert colliding", hashInsertColliding<HashTable<long long, int>>,
+                hashInsertColliding<unordered_map<long long, int>>, constant);
+    checkGrowth("hash remove", hashRemove<HashTable<int, int>>, hashRemove<unordered_map<int, int>>, constant);
+}
+
+/*Contadores de DICT_STATS: no dependen del tiempo*/
+void countersCheck()
+{
+    TestSection section("stats counters");
+    const size_t n = MaxN;
+
+    HashTable<long long, int> table;
+    for (size_t i = 0; i < n; ++i)
+        table.insert((long long)i << 24, 1);
+    for (size_t i = 0; i < n; ++i)
+        sink += table.find((long long)i << 24);
+    HashTableStats hs = table.stats();
+    // Duplicando capacity hacen falta log2(n) rehashing desde la tabla inicial
+    ASSERT(hs.rehashes <= (size_t)log2((double)n) + 2, "HashTable rehashes too often (" << hs.rehashes << ")");
+    // Con factor de carga <= 1 una busqueda exitosa compara ~1 + carga / 2 nodos
+    ASSERT(hs.avgProbe < 2.5, "HashTable probes too long (" << hs.avgProbe << ")");
+    ASSERT(hs.maxChain < 32, "HashTable has a pathological chain (" << hs.maxChain << ")");
+
+    // find_many cuenta cada clave como una busqueda, con sus sondeos
+    vector<long long> batch;
+    for (size_t i = 0; i < 2 * n; ++i)
+        batch.push_back((long long)i << 24); // la mitad no estan
+    table.reset_stats();
+    vector<int *> out = table.find_many(batch);
+    hs = table.stats();
+    ASSERT(hs.lookups == batch.size(), "find_many does not count its lookups (" << hs.lookups << ")");
+    ASSERT(hs.avgProbe > 0 && hs.avgProbe < 2.5, "find_many probes are not counted (" << hs.avgProbe << ")");
+
+    // Con rehashing incremental la migracion que hacen las busquedas se mide
+    HashTable<int, int> incremental;
+    incremental.incremental_rehash(true);
+    size_t buckets = incremental.bucket_count();
+    int next = 0;
+    while (incremental.bucket_count() == buckets)
+        incremental.insert(next++, 1);
+    incremental.reset_stats(); // el rehashing que empezo la migracion queda afuera
+    for (int k = 0; k < next; ++k)
+        sink += incremental.find(k);
+    HashTableStats is = incremental.stats();
+    ASSERT(is.rehashes == 0 && is.rehashSeconds > 0, "Incremental migration is not timed in rehashSeconds");
+
+    AVLTree<int> tree;
+    for (size_t i = 0; i < n; ++i)
+        tree.insert((int)i);
+    for (size_t i = 0; i < n; ++i)
+        sink += tree.find((int)i);
+    AVLTreeStats ts = tree.stats();
+    // Cada insert hace a lo sumo una rotacion (simple o doble)
+    ASSERT(ts.rotationsLL + ts.rotationsRR + ts.rotationsLR + ts.rotationsRL <= n, "AVL rotates more than once per insert");
+    ASSERT(ts.rotationsRR > 0, "AVL never rebalanced ascending inserts");
+    ASSERT(ts.avgSearchDepth <= ts.height + 1, "AVL search depth exceeds its height");
+}
+
+int main()
+{
+    TesterQuiet = true;
+    mt19937_64 rng(2024);
+    {
+        TestSection section("differential");
+        for (size_t n : {1000, 10000, 100000})
+        {
+            differentialAVL<int>(n, rng);
+            differentialHash<int>(n, rng);
+            differentialHash<int>(n, rng, true);
+            differentialSetAlgebra<int>(n, rng);
+            differentialRanges<int>(n, rng);
+            differentialBulk<int>(n, rng);
+            differentialHashBatch<int>(n, rng, false);
+            differentialHashBatch<int>(n, rng, true);
+        }
+        differentialAVL<string>(20000, rng);
+        differentialHash<string>(20000, rng);
+        differentialHash<string>(20000, rng, true);
+        differentialSetAlgebra<string>(20000, rng);
+        differentialRanges<string>(20000, rng);
+        differentialBulk<string>(20000, rng);
+        differentialHashBatch<string>(20000, rng, true);
+        differentialKeyWriter<int>(20000, rng);
+        differentialKeyWriter<string>(20000, rng);
+    }
+    differentialMoves<allocator<pair<const int, int>>>();
+    differentialMoves<PoolAllocator<pair<const int, int>>>();
+    {
+        TestSection section("differential NodePool");
+        for (size_t n : {1000, 100000})
+        {
+            differentialAVL<int, PoolAllocator<int>>(n, rng);
+            differentialHash<int, PoolAllocator<pair<const int, int>>>(n, rng);
+            differentialHash<int, PoolAllocator<pair<const int, int>>>(n, rng, true);
+            differentialSetAlgebra<int>(n, rng, PoolAllocator<int>());
+        }
+        differentialAVL<string, PoolAllocator<string>>(20000, rng);
+        differentialHash<string, PoolAllocator<pair<const string, int>>>(20000, rng);
+        differentialSetAlgebra<string>(20000, rng, PoolAllocator<string>());
+    }
+    complexityAVL();
+    complexityHash();
+    countersCheck();
+    return TesterExitCode();
+}
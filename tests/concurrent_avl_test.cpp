@@ -0,0 +1,170 @@
+/*
+ * ConcurrentAVLTree:
+ * 1. Operaciones al azar contra std::set en un solo hilo.
+ * 2. Lectores sin locks mientras un escritor inserta y elimina (con
+ *    rotaciones en todo el arbol): las claves pares nunca se eliminan, asi
+ *    find las encuentra siempre, successor/predecessor de una par no se
+ *    saltan la par siguiente/anterior, y forEach entrega claves en orden
+ *    estrictamente creciente que incluyen todas las pares.
+ * 3. forEach cuyo callback inserta y elimina: la pila se invalida a cada paso.
+ * Corre en modo silencioso: solo imprime los ASSERT que fallan y el resumen.
+ */
+#include <atomic>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+#include "ConcurrentAVLTree.h"
+#include "tester.h"
+
+using namespace std;
+
+void differential(size_t n, mt19937_64 &rng)
+{
+    ConcurrentAVLTree<int> tree;
+    set<int> ref;
+    int range = (int)(2 * n);
+
+    bool same = true;
+    for (size_t i = 0; i < 3 * n; ++i)
+    {
+        int key = (int)(rng() % range);
+        unsigned op = (unsigned)(rng() % 5);
+        if (op < 2)
+            same = same && tree.insert(key) == ref.insert(key).second;
+        else if (op == 2)
+            same = same && tree.remove(key) == (ref.erase(key) == 1);
+        else if (op == 3)
+            same = same && tree.find(key) == (ref.count(key) == 1);
+        else
+        {
+            int succ = -1, pred = -1;
+            auto up = ref.upper_bound(key);
+            auto low = ref.lower_bound(key);
+            same = same && tree.successor(key, succ) == (up != ref.end()) && (up == ref.end() || succ == *up);
+            same = same && tree.predecessor(key, pred) == (low != ref.begin()) && (low == ref.begin() || pred == *prev(low));
+        }
+    }
+    ASSERT(same, "ConcurrentAVLTree differs from set");
+    ASSERT(tree.getSize() == ref.size(), "ConcurrentAVLTree size differs");
+    ASSERT(tree.getAll() == vector<int>(ref.begin(), ref.end()), "forEach must return the keys in order");
+}
+
+void readersAndWriter(unsigned readers)
+{
+    TestSection s("concurrent stress");
+    const int range = 1 << 14; // pares estables en [0, range)
+    ConcurrentAVLTree<int> tree;
+    set<int> ref;
+    for (int k = 0; k < range; k += 2)
+    {
+        tree.insert(k);
+        ref.insert(k);
+    }
+
+    atomic<bool> done(false);
+    atomic<int> misses(0), badNeighbors(0), badWalks(0);
+    vector<thread> threads;
+    for (unsigned r = 0; r < readers; ++r)
+    {
+        threads.emplace_back([&, r]
+                             {
+            mt19937 rng(r);
+            int rounds = 0;
+            while (!done.load(memory_order_acquire) || rounds < 5)
+            {
+                for (int i = 0; i < 2000; ++i)
+                {
+                    int k = (int)(rng() % (range / 2)) * 2;
+                    if (!tree.find(k))
+                        misses.fetch_add(1);
+                    int next = -1, before = -1;
+                    if (k + 2 < range && (!tree.successor(k, next) || next <= k || next > k + 2))
+                        badNeighbors.fetch_add(1);
+                    if (k > 0 && (!tree.predecessor(k, before) || before >= k || before < k - 2))
+                        badNeighbors.fetch_add(1);
+                }
+                if (r == 0 || rounds % 8 == 0)
+                {
+                    int last = -1, evens = 0;
+                    bool ordered = true;
+                    tree.forEach([&](int k)
+                                 {
+                        ordered = ordered && k > last;
+                        last = k;
+                        evens += k % 2 == 0; });
+                    if (!ordered || evens != range / 2)
+                        badWalks.fetch_add(1);
+                }
+                rounds++;
+            } });
+    }
+
+    // Solo claves impares: inserciones y eliminaciones rotan nodos pares
+    mt19937_64 rng(99);
+    for (int i = 0; i < 200000; ++i)
+    {
+        int k = (int)(rng() % (range / 2)) * 2 + 1;
+        if (rng() % 2)
+        {
+            tree.insert(k);
+            ref.insert(k);
+        }
+        else
+        {
+            tree.remove(k);
+            ref.erase(k);
+        }
+    }
+    done.store(true, memory_order_release);
+    for (thread &t : threads)
+        t.join();
+
+    ASSERT(misses.load() == 0, "A reader missed a key that was never removed");
+    ASSERT(badNeighbors.load() == 0, "successor/predecessor skipped a key that was never removed");
+    ASSERT(badWalks.load() == 0, "forEach was out of order or skipped a key that was never removed");
+    ASSERT(tree.getAll() == vector<int>(ref.begin(), ref.end()), "The writer lost keys");
+}
+
+// El callback de forEach modifica el arbol: cada paso invalida nodos de la
+// pila y obliga a reconstruirla desde la ultima clave
+void mutatingWalk()
+{
+    const int range = 4096;
+    ConcurrentAVLTree<int> tree;
+    for (int k = 0; k < range; ++k)
+        tree.insert(k);
+
+    mt19937_64 rng(3);
+    int last = -1, evens = 0;
+    bool ordered = true;
+    tree.forEach([&](int k)
+                 {
+        ordered = ordered && k > last;
+        last = k;
+        evens += k % 2 == 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            int odd = (int)(rng() % (range / 2)) * 2 + 1;
+            if (rng() % 2)
+                tree.remove(odd);
+            else
+                tree.insert(odd);
+        } });
+    ASSERT(ordered && evens == range / 2, "forEach must survive changes made during the walk");
+}
+
+int main()
+{
+    TesterQuiet = true;
+    mt19937_64 rng(5);
+
+    {
+        TestSection s("differential");
+        for (size_t n : {100, 1000, 10000})
+            differential(n, rng);
+    }
+    mutatingWalk();
+    readersAndWriter(3);
+    return TesterExitCode();
+}
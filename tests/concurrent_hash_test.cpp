@@ -0,0 +1,136 @@
+/*
+ * ConcurrentHashTable con varios hilos:
+ * 1. Escritores en rangos disjuntos mas claves compartidas que todos
+ *    sobrescriben: al final estan todas las claves con un valor valido, y el
+ *    orden global respeta el orden en que cada hilo inserto las suyas.
+ * 2. Lectores con get/find mientras otros hilos insertan y eliminan: las
+ *    claves que nunca se eliminan se encuentran siempre con su valor, y
+ *    getAllElements() es una copia consistente (sin claves repetidas).
+ * Corre en modo silencioso: solo imprime los ASSERT que fallan y el resumen.
+ */
+#include <atomic>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ConcurrentHashTable.h"
+#include "tester.h"
+
+using namespace std;
+
+static const int Threads = 4;
+
+void disjointWriters()
+{
+    TestSection s("disjoint writers");
+    const int perThread = 20000;
+    const int shared = 64;
+    ConcurrentHashTable<string, int> table(16);
+
+    vector<thread> threads;
+    for (int t = 0; t < Threads; ++t)
+    {
+        threads.emplace_back([&, t]
+                             {
+            for (int i = 0; i < perThread; ++i)
+            {
+                table.insert("t" + to_string(t) + ":" + to_string(i), i);
+                table.insert("shared" + to_string(i % shared), t);
+            } });
+    }
+    for (thread &t : threads)
+        t.join();
+
+    ASSERT(table.getSize() == (size_t)(Threads * perThread + shared), "Concurrent inserts lost keys");
+
+    bool values = true;
+    for (int t = 0; t < Threads; ++t)
+        for (int i = 0; i < perThread; i += 97)
+            values = values && table.at("t" + to_string(t) + ":" + to_string(i)) == i;
+    for (int i = 0; i < shared; ++i)
+    {
+        int v = -1;
+        values = values && table.get("shared" + to_string(i), v) && v >= 0 && v < Threads;
+    }
+    ASSERT(values, "Concurrent inserts stored a wrong value");
+
+    // Las claves de cada hilo aparecen en el orden en que ese hilo las inserto
+    vector<int> next(Threads, 0);
+    bool ordered = true;
+    for (const string &key : table.getAllKeys())
+    {
+        if (key[0] != 't')
+            continue;
+        size_t colon = key.find(':');
+        int t = stoi(key.substr(1, colon - 1));
+        int i = stoi(key.substr(colon + 1));
+        ordered = ordered && i == next[t];
+        next[t] = i + 1;
+    }
+    ASSERT(ordered, "The global order does not follow each thread's insertion order");
+}
+
+void readersAndWriters()
+{
+    TestSection s("readers and writers");
+    const int stable = 2000; // nunca se eliminan
+    ConcurrentHashTable<int, int> table(8);
+    for (int k = 0; k < stable; ++k)
+        table.insert(k, k * 3);
+
+    atomic<bool> done(false);
+    atomic<int> misses(0), wrongValues(0), badSnapshots(0);
+    vector<thread> threads;
+    for (int r = 0; r < Threads - 1; ++r)
+    {
+        threads.emplace_back([&, r]
+                             {
+            unsigned x = (unsigned)r + 1;
+            int rounds = 0;
+            while (!done.load(memory_order_acquire) || rounds < 10)
+            {
+                for (int i = 0; i < 1000; ++i)
+                {
+                    x = x * 1103515245u + 12345u;
+                    int k = (int)(x % stable);
+                    int v = -1;
+                    if (!table.get(k, v) || !table.find(k))
+                        misses.fetch_add(1);
+                    else if (v != k * 3)
+                        wrongValues.fetch_add(1);
+                }
+                if (r == 0 && rounds % 20 == 0)
+                {
+                    set<int> seen;
+                    for (auto &item : table.getAllElements())
+                        if (!seen.insert(item.first).second)
+                            badSnapshots.fetch_add(1);
+                }
+                rounds++;
+            } });
+    }
+
+    for (int k = stable; k < stable + 50000; ++k)
+    {
+        table.insert(k, k * 3);
+        if (k % 2 == 0)
+            table.remove(k);
+    }
+    done.store(true, memory_order_release);
+    for (thread &t : threads)
+        t.join();
+
+    ASSERT(misses.load() == 0, "A reader missed a key that was never removed");
+    ASSERT(wrongValues.load() == 0, "A reader saw a wrong value");
+    ASSERT(badSnapshots.load() == 0, "getAllElements() returned a repeated key");
+    ASSERT(table.getSize() == (size_t)(stable + 25000), "The writer lost keys");
+}
+
+int main()
+{
+    TesterQuiet = true;
+
+    disjointWriters();
+    readersAndWriters();
+    return TesterExitCode();
+}
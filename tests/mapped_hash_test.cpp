@@ -0,0 +1,196 @@
+/*
+ * HashTable::save + MappedHashTable:
+ * 1. Ida y vuelta con claves/valores string y triviales: mismo contenido,
+ *    mismo orden de insercion, aciertos y fallos de find/at.
+ * 2. Archivos corruptos: cabecera truncada o con tamaños que desbordan,
+ *    slots del indice fuera de rango, indice sin slots vacios y referencias
+ *    a string fuera del blob. Abrir o leer lanza runtime_error y ninguna
+ *    busqueda se queda en un ciclo.
+ * Corre en modo silencioso: solo imprime los ASSERT que fallan y el resumen.
+ */
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "HashTable.h"
+#include "MappedHashTable.h"
+#include "tester.h"
+
+using namespace std;
+
+static const string snapshotPath = "mapped_hash_test.snap";
+
+string readFile(const string &path)
+{
+    ifstream in(path, ios::binary);
+    return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+}
+
+void writeFile(const string &path, const string &bytes)
+{
+    ofstream out(path, ios::binary | ios::trunc);
+    out.write(bytes.data(), (streamsize)bytes.size());
+}
+
+SnapshotHeader headerOf(const string &bytes)
+{
+    SnapshotHeader header;
+    memcpy(&header, bytes.data(), sizeof(header));
+    return header;
+}
+
+void setField(string &bytes, size_t offset, uint64_t value)
+{
+    memcpy(&bytes[offset], &value, sizeof(value));
+}
+
+// true si abrir y recorrer el archivo, y buscar la clave, lanza runtime_error
+bool rejects(const string &bytes, const string &probe)
+{
+    writeFile(snapshotPath, bytes);
+    try
+    {
+        MappedHashTable<string, string> mapped(snapshotPath);
+        mapped.find(probe);
+        mapped.forEach([](string_view, string_view) {});
+    }
+    catch (const runtime_error &)
+    {
+        return true;
+    }
+    return false;
+}
+
+void roundTripStrings()
+{
+    HashTable<string, string> table;
+    for (int i = 0; i < 5000; ++i)
+        table.insert("key" + to_string(i), string(i % 40, 'v') + to_string(i));
+    for (int i = 0; i < 5000; i += 7)
+        table.remove("key" + to_string(i));
+    table.save(snapshotPath);
+
+    MappedHashTable<string, string> mapped(snapshotPath);
+    ASSERT(mapped.getSize() == (size_t)table.getSize(), "The snapshot size differs");
+    ASSERT(mapped.getAllElements() == table.getAllElements(), "The snapshot lost the insertion order");
+
+    bool same = true;
+    for (int i = 0; i < 5000; ++i)
+    {
+        string key = "key" + to_string(i);
+        if (mapped.find(key) != table.find(key) || (table.find(key) && mapped.at(key) != table.at(key)))
+            same = false;
+    }
+    ASSERT(same, "find/at on the snapshot differ from the table");
+    ASSERT(!mapped.find("missing"), "A missing key must not be found");
+
+    bool threw = false;
+    try
+    {
+        mapped.at("missing");
+    }
+    catch (const out_of_range &)
+    {
+        threw = true;
+    }
+    ASSERT(threw, "at() of a missing key must throw out_of_range");
+}
+
+void roundTripTrivial()
+{
+    HashTable<int64_t, double> table;
+    for (int64_t i = 0; i < 3000; ++i)
+        table.insert(i << 20, i * 0.5);
+    table.save(snapshotPath);
+
+    MappedHashTable<int64_t, double> mapped(snapshotPath);
+    ASSERT(mapped.getAllElements() == table.getAllElements(), "The trivial snapshot differs");
+    ASSERT(mapped.at((int64_t)1234 << 20) == 617.0 && !mapped.find(1), "find/at on the trivial snapshot failed");
+
+    HashTable<int64_t, double> empty;
+    empty.save(snapshotPath);
+    MappedHashTable<int64_t, double> none(snapshotPath);
+    ASSERT(none.getSize() == 0 && !none.find(0), "An empty snapshot must open");
+}
+
+void corruptFiles()
+{
+    HashTable<string, string> table;
+    for (int i = 0; i < 100; ++i)
+        table.insert("key" + to_string(i), "value" + to_string(i));
+    table.save(snapshotPath);
+    const string good = readFile(snapshotPath);
+    const SnapshotHeader header = headerOf(good);
+    const uint64_t recordSize = 8 + 16 + 16;
+
+    ASSERT(!rejects(good, "key1"), "A valid snapshot must open");
+    ASSERT(rejects(good.substr(0, sizeof(SnapshotHeader) - 1), "key1"), "A truncated header must be rejected");
+    ASSERT(rejects(good.substr(0, good.size() - 1), "key1"), "A truncated file must be rejected");
+
+    string bad = good;
+    bad[0] = 'X';
+    ASSERT(rejects(bad, "key1"), "A bad magic must be rejected");
+
+    // 2^61 * 40 y 2^62 * 8 desbordan a 0: los offsets encadenados cuadran
+    bad = good;
+    setField(bad, offsetof(SnapshotHeader, count), (uint64_t)1 << 61);
+    setField(bad, offsetof(SnapshotHeader, indexSize), (uint64_t)1 << 62);
+    setField(bad, offsetof(SnapshotHeader, indexOffset), header.entriesOffset);
+    setField(bad, offsetof(SnapshotHeader, blobOffset), header.entriesOffset);
+    ASSERT(rejects(bad, "key1"), "An overflowing count must be rejected");
+
+    // indexSize * 8 desborda y vuelve a dar el blobOffset guardado
+    bad = good;
+    setField(bad, offsetof(SnapshotHeader, indexSize), (uint64_t)1 << 61);
+    setField(bad, offsetof(SnapshotHeader, blobOffset), header.indexOffset);
+    ASSERT(rejects(bad, "key1"), "An overflowing index size must be rejected");
+
+    bad = good;
+    setField(bad, offsetof(SnapshotHeader, entriesOffset), good.size() + 8);
+    ASSERT(rejects(bad, "key1"), "Offsets past the end must be rejected");
+
+    // Todos los slots del indice con un numero de entrada mayor que count
+    bad = good;
+    for (uint64_t i = 0; i < header.indexSize; ++i)
+        setField(bad, header.indexOffset + i * 8, header.count + 1 + i);
+    ASSERT(rejects(bad, "key1"), "Index slots past count must be rejected");
+
+    // Indice sin slots vacios: buscar una clave que no esta debe terminar
+    bad = good;
+    for (uint64_t i = 0; i < header.indexSize; ++i)
+    {
+        uint64_t slot;
+        memcpy(&slot, &bad[header.indexOffset + i * 8], 8);
+        if (!slot)
+            setField(bad, header.indexOffset + i * 8, 1);
+    }
+    writeFile(snapshotPath, bad);
+    {
+        MappedHashTable<string, string> full(snapshotPath);
+        ASSERT(!full.find("missing") && full.find("key42"), "A full index must not loop forever");
+    }
+
+    // Referencia (offset, longitud) de la clave 0 y del valor 1 fuera del blob
+    bad = good;
+    setField(bad, header.entriesOffset + 8, good.size());
+    ASSERT(rejects(bad, "key0"), "A key reference past the blob must be rejected");
+    bad = good;
+    setField(bad, header.entriesOffset + recordSize + 8 + 16 + 8, ~(uint64_t)0);
+    ASSERT(rejects(bad, "key1"), "A value length past the blob must be rejected");
+}
+
+int main()
+{
+    TesterQuiet = true;
+
+    roundTripStrings();
+    roundTripTrivial();
+    corruptFiles();
+
+    remove(snapshotPath.c_str());
+    return TesterExitCode();
+}
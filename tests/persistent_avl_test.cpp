@@ -0,0 +1,137 @@
+/*
+ * PersistentAVLTree:
+ * 1. Snapshots tomados cada pocos cambios mientras el arbol sigue mutando
+ *    (insert y remove al azar): cada snapshot conserva su contenido viejo
+ *    (recorrido en orden, size y find) hasta el final, aunque se suelten
+ *    otros snapshots en el medio.
+ * 2. Copias del arbol (O(1), comparten nodos) que mutan por separado.
+ * Corre en modo silencioso: solo imprime los ASSERT que fallan y el resumen.
+ */
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "PersistentAVLTree.h"
+#include "tester.h"
+
+using namespace std;
+
+template <typename View>
+vector<int> inOrder(View &view)
+{
+    vector<int> values;
+    for (auto it = view.begin(AVLIterator<int>::InOrder); it != view.end(); ++it)
+        values.push_back(*it);
+    return values;
+}
+
+template <typename View>
+bool matches(View &view, const set<int> &expected, int range)
+{
+    if (view.size() != (int)expected.size() || inOrder(view) != vector<int>(expected.begin(), expected.end()))
+        return false;
+    for (int k = -1; k <= range; k += 7)
+        if (view.find(k) != (expected.count(k) == 1))
+            return false;
+    return true;
+}
+
+void snapshotsKeepOldVersions(mt19937_64 &rng)
+{
+    TestSection s("snapshots");
+    typedef PersistentAVLTree<int>::Snapshot Snapshot;
+    const int range = 2000;
+    PersistentAVLTree<int> tree;
+    set<int> ref;
+    vector<Snapshot> snapshots;
+    vector<set<int>> expected;
+
+    bool kept = true;
+    for (int step = 0; step < 20000; ++step)
+    {
+        int k = (int)(rng() % range);
+        if (rng() % 3)
+        {
+            tree.insert(k);
+            ref.insert(k);
+        }
+        else
+        {
+            tree.remove(k);
+            ref.erase(k);
+        }
+
+        if (step % 97 == 0)
+        {
+            snapshots.push_back(tree.snapshot());
+            expected.push_back(ref);
+        }
+        // Suelta un snapshot viejo de vez en cuando: los demas no cambian
+        if (step % 1009 == 0 && snapshots.size() > 2)
+        {
+            size_t victim = (size_t)(rng() % (snapshots.size() - 1));
+            snapshots.erase(snapshots.begin() + victim);
+            expected.erase(expected.begin() + victim);
+        }
+        if (step % 2000 == 0)
+            for (size_t i = 0; i < snapshots.size(); ++i)
+                kept = kept && matches(snapshots[i], expected[i], range);
+    }
+
+    for (size_t i = 0; i < snapshots.size(); ++i)
+        kept = kept && matches(snapshots[i], expected[i], range);
+    ASSERT(kept, "A snapshot changed after the tree was mutated");
+    ASSERT(matches(tree, ref, range), "The live tree differs from set");
+
+    // El arbol vaciado no afecta a los snapshots
+    tree.clear();
+    bool afterClear = tree.size() == 0;
+    for (size_t i = 0; i < snapshots.size(); ++i)
+        afterClear = afterClear && matches(snapshots[i], expected[i], range);
+    ASSERT(afterClear, "Clearing the tree changed a snapshot");
+}
+
+void copiesMutateIndependently(mt19937_64 &rng)
+{
+    const int range = 500;
+    PersistentAVLTree<int> a;
+    set<int> refA;
+    for (int i = 0; i < 300; ++i)
+    {
+        int k = (int)(rng() % range);
+        a.insert(k);
+        refA.insert(k);
+    }
+
+    PersistentAVLTree<int> b(a);
+    set<int> refB = refA;
+    for (int i = 0; i < 2000; ++i)
+    {
+        int k = (int)(rng() % range);
+        if (i % 2)
+        {
+            a.insert(k);
+            refA.insert(k);
+            b.remove(k);
+            refB.erase(k);
+        }
+        else
+        {
+            a.remove(k);
+            refA.erase(k);
+            b.insert(k);
+            refB.insert(k);
+        }
+    }
+    ASSERT(matches(a, refA, range) && matches(b, refB, range), "Tree copies must not see each other's changes");
+}
+
+int main()
+{
+    TesterQuiet = true;
+    mt19937_64 rng(11);
+
+    snapshotsKeepOldVersions(rng);
+    copiesMutateIndependently(rng);
+    return TesterExitCode();
+}
@@ -0,0 +1,131 @@
+/*
+ * RcuHashTable:
+ * 1. Operaciones al azar contra std::unordered_map y el orden de insercion.
+ * 2. Lectores sin locks mientras un escritor inserta (con muchos
+ *    rehashing), sobrescribe y elimina: las claves que nunca se eliminan se
+ *    encuentran siempre y con su valor, y forEach ve la lista completa.
+ * Corre en modo silencioso: solo imprime los ASSERT que fallan y el resumen.
+ */
+#include <atomic>
+#include <list>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "RcuHashTable.h"
+#include "tester.h"
+
+using namespace std;
+
+void differential(size_t n, mt19937_64 &rng)
+{
+    RcuHashTable<string, int> table(2);
+    unordered_map<string, int> ref;
+    list<string> order;
+    uint64_t range = 2 * n;
+
+    bool same = true;
+    for (size_t i = 0; i < 3 * n; ++i)
+    {
+        string key = "k" + to_string(rng() % range);
+        int value = (int)(rng() % 1000);
+        unsigned op = (unsigned)(rng() % 4);
+        if (op < 2)
+        {
+            if (!ref.count(key))
+                order.push_back(key);
+            table.insert(key, value);
+            ref[key] = value;
+        }
+        else if (op == 2)
+        {
+            if (table.remove(key) != (ref.erase(key) == 1))
+                same = false;
+            order.remove(key);
+        }
+        else
+        {
+            int got = -1;
+            bool found = table.get(key, got);
+            if (found != (ref.count(key) == 1) || (found && got != ref[key]))
+                same = false;
+        }
+    }
+    ASSERT(same, "RcuHashTable differs from unordered_map");
+    ASSERT(table.getSize() == ref.size(), "RcuHashTable size differs");
+
+    vector<pair<string, int>> expected;
+    for (const string &key : order)
+        expected.emplace_back(key, ref[key]);
+    ASSERT(table.getAllElements() == expected, "RcuHashTable lost the insertion order");
+}
+
+void concurrentReaders(unsigned readers)
+{
+    TestSection s("concurrent readers");
+    const int stable = 1000;  // nunca se eliminan
+    const int churn = 200000; // el escritor las inserta y elimina
+    RcuHashTable<int, int> table(2);
+    for (int k = 0; k < stable; ++k)
+        table.insert(k, k);
+
+    atomic<bool> done(false);
+    atomic<size_t> misses(0), wrongValues(0), shortWalks(0);
+    vector<thread> threads;
+    for (unsigned r = 0; r < readers; ++r)
+    {
+        threads.emplace_back([&, r]
+                             {
+            mt19937_64 rng(r);
+            while (!done.load(memory_order_acquire))
+            {
+                EpochGuard guard;
+                for (int i = 0; i < 1000; ++i)
+                {
+                    int k = (int)(rng() % stable);
+                    int value = -1;
+                    if (!table.get(k, value))
+                        misses.fetch_add(1);
+                    else if (value != k)
+                        wrongValues.fetch_add(1);
+                }
+                size_t seen = 0;
+                table.forEach([&](int key, int)
+                              { seen += key < stable; });
+                if (seen != (size_t)stable)
+                    shortWalks.fetch_add(1);
+            } });
+    }
+
+    size_t removed = 0;
+    for (int k = stable; k < stable + churn; ++k)
+    {
+        table.insert(k, k);
+        table.insert(k % stable, k % stable); // reemplaza el nodo de una clave estable
+        if (k % 3 == 0)
+            removed += table.remove(k);
+    }
+    done.store(true, memory_order_release);
+    for (thread &t : threads)
+        t.join();
+
+    ASSERT(misses.load() == 0, "A reader missed a key that was never removed");
+    ASSERT(wrongValues.load() == 0, "A reader saw a wrong value");
+    ASSERT(shortWalks.load() == 0, "forEach skipped keys that were never removed");
+    ASSERT(table.getSize() == stable + churn - removed, "The writer lost keys");
+}
+
+int main()
+{
+    TesterQuiet = true;
+    mt19937_64 rng(7);
+
+    {
+        TestSection s("differential");
+        for (size_t n : {100, 1000, 5000})
+            differential(n, rng);
+    }
+    concurrentReaders(3);
+    return TesterExitCode();
+}